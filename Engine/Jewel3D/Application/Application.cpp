@@ -3,6 +3,8 @@
 #include "Application.h"
 #include "Logging.h"
 #include "Timer.h"
+#include "TimerWheel.h"
+#include "Jewel3D/Entity/SystemScheduler.h"
 #include "Jewel3D/Input/Input.h"
 #include "Jewel3D/Math/Math.h"
 #include "Jewel3D/Rendering/Light.h"
@@ -435,19 +437,28 @@ namespace Jwl
 
 	void Application::UpdateEngine()
 	{
-		// Distribute all queued events to their listeners.
+		// Fire the timers due on this step. The events that they push are delivered below.
+		TimerQueue.Advance();
+
+		// Distribute all queued events to their listeners, including those posted from other threads.
 		EventQueue.Dispatch();
 
+		// Run the game's systems.
+		SystemScheduler.Run();
+
+		// Bring the cached world transforms up to date, so that they can be read from parallel updates.
+		Entity::UpdateWorldTransforms();
+
 		// Update engine components.
 		for (auto& emitter : All<ParticleEmitter>())
 		{
 			emitter.Update();
 		}
 
-		for (auto& light : All<Light>())
-		{
+		// Lights only write to their own uniform buffers, so they can be updated in parallel.
+		ParallelForEach<Light>([](Light& light) {
 			light.Update();
-		}
+		});
 
 		// Step the SoundSystem.
 		SoundSystem.Update();
@@ -717,7 +728,7 @@ namespace Jwl
 			app.screenViewport.height = HIWORD(lParam);
 			app.screenViewport.bind();
 
-			EventQueue.Push(std::make_unique<Resize>(app.screenViewport.width, app.screenViewport.height));
+			EventQueue.Push<Resize>(app.screenViewport.width, app.screenViewport.height);
 			return 0; break;
 		}
 
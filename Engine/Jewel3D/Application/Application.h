@@ -23,9 +23,11 @@ namespace Jwl
 		void GameLoop(std::function<void()> update, std::function<void()> draw);
 
 		//- Updates systems provided by the engine.
-		//	1. Dispatches the event queue.
-		//	2. Updates all Engine-Side components.
-		//	3. Steps the Sound System.
+		//	1. Advances the TimerQueue by one tick.
+		//	2. Dispatches the event queue.
+		//	3. Runs the systems registered with the SystemScheduler.
+		//	4. Updates all Engine-Side components.
+		//	5. Steps the Sound System.
 		void UpdateEngine();
 
 		//- Stops the GameLoop.
@@ -5,42 +5,60 @@
 
 namespace Jwl
 {
-	void EventQueue::Push(std::unique_ptr<EventBase> e)
+	void EventQueue::Dispatch(const EventBase& e) const
+	{
+		e.Raise();
+	}
+
+	void EventQueue::Dispatch()
 	{
-#ifdef _DEBUG
-		ASSERT(!inDispatch,
-			"It is dangerous to add a new event to the queue while currently inside a global Dispatch().\n"
-			"Consider using Dispatch(const EventBase&) instead.");
-#endif
+		PushPostedEvents();
+
+		// New events are deferred until the next call.
+		inDispatch = true;
 
-		if (e->HasListeners())
+		// Sequence through all events, one run of the same type at a time.
+		for (auto& run : pendingRuns)
 		{
-			eventQueue.push(std::move(e));
+			run.channel->Dispatch(run.count);
 		}
+		pendingRuns.clear();
+
+		inDispatch = false;
 	}
 
-	void EventQueue::Dispatch(const EventBase& e) const
+	EventQueue::~EventQueue()
 	{
-		e.Raise();
+		auto posted = postedEvents.exchange(nullptr, std::memory_order_acquire);
+		while (posted != nullptr)
+		{
+			auto next = posted->next;
+			delete posted;
+			posted = next;
+		}
 	}
 
-	void EventQueue::Dispatch()
+	void EventQueue::PushPostedEvents()
 	{
-		// Events should not be posted during this call.
-#ifdef _DEBUG
-		inDispatch = true;
-#endif
+		// Take the whole stack at once. Threads can continue posting to the now-empty stack.
+		auto posted = postedEvents.exchange(nullptr, std::memory_order_acquire);
 
-		// Sequence through all events.
-		while (!eventQueue.empty())
+		// Reverse the stack to restore the order in which the events were posted.
+		detail::PostedEventBase* ordered = nullptr;
+		while (posted != nullptr)
 		{
-			eventQueue.front()->Raise();
-			eventQueue.pop();
+			auto next = posted->next;
+			posted->next = ordered;
+			ordered = posted;
+			posted = next;
 		}
 
-		// Events can be posted again.
-#ifdef _DEBUG
-		inDispatch = false;
-#endif
+		while (ordered != nullptr)
+		{
+			auto next = ordered->next;
+			ordered->Push();
+			delete ordered;
+			ordered = next;
+		}
 	}
 }
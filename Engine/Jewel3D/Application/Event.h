@@ -1,14 +1,24 @@
 // Copyright (c) 2017 Emilian Cioca
 #pragma once
+#include "Jewel3D/Application/Logging.h"
+#include "Jewel3D/Utilities/InlineFunction.h"
+#include "Jewel3D/Utilities/RingBuffer.h"
 #include "Jewel3D/Utilities/Singleton.h"
 
-#include <functional>
-#include <memory>
-#include <queue>
+#include <atomic>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace Jwl
 {
+	template<class derived> class Event;
+
+	namespace detail
+	{
+		template<class EventObj> class EventChannel;
+	}
+
 	//- The base class for event objects.
 	class EventBase
 	{
@@ -27,11 +37,16 @@ namespace Jwl
 	//- Invokes the callback function when an instance of the respective event is dispatched.
 	//- The template parameter must be the event object that the listener will subscribe to.
 	//	For example: Listener<PlayerDeath> OnPlayerDeath(&myFunc);
+	//- Listeners can be created and destroyed at any time, including from inside of a callback.
 	template <class EventObj>
 	class Listener
 	{
 		static_assert(std::is_base_of<EventBase, EventObj>::value, "Template argument must inherit from Event.");
+		friend Event<EventObj>;
 	public:
+		//- Small callbacks, such as lambdas with a few captures, are stored without allocating.
+		using Callback = InlineFunction<void(const EventObj&)>;
+
 		//- Constructs the listener without a connection to a callback function.
 		Listener()
 		{
@@ -39,8 +54,15 @@ namespace Jwl
 		}
 
 		//- Constructs the listener with a callback function.
-		Listener(std::function<void(const EventObj&)> callbackFunc)
-			: callback(callbackFunc)
+		Listener(Callback callbackFunc)
+			: callback(std::move(callbackFunc))
+		{
+			EventObj::Subscribe(*this);
+		}
+
+		//- Constructs a separate listener with the same callback function.
+		Listener(const Listener& other)
+			: callback(other.callback)
 		{
 			EventObj::Subscribe(*this);
 		}
@@ -51,8 +73,19 @@ namespace Jwl
 			EventObj::Unsubscribe(*this);
 		}
 
+		//- Copies the callback function. Both listeners remain subscribed.
+		Listener& operator=(const Listener& other)
+		{
+			callback = other.callback;
+			return *this;
+		}
+
 		//- The callback function invoked when an event of the templated type is dispatched.
-		std::function<void(const EventObj&)> callback;
+		Callback callback;
+
+	private:
+		//- The position of the listener in the list of its event.
+		u32 slot = 0;
 	};
 
 	//- You can inherit from this class to create your own custom events.
@@ -62,6 +95,8 @@ namespace Jwl
 	class Event : public EventBase
 	{
 		friend Listener<derived>;
+		friend detail::EventChannel<derived>;
+		friend class EventQueue;
 	public:
 		virtual ~Event() = default;
 
@@ -72,6 +107,8 @@ namespace Jwl
 		}
 
 		//- Returns a vector of all objects currently listening for this type of event.
+		//- Listeners are not kept in any particular order. While the event is being raised,
+		//  the vector might also contain null entries in place of removed listeners.
 		static const auto& GetListenersStatic()
 		{
 			return listeners;
@@ -80,61 +117,253 @@ namespace Jwl
 		//- Returns true if at least one listener responds to this type of event.
 		static bool HasListenersStatic()
 		{
-			return !listeners.empty();
+			return listeners.size() > numRemoved;
 		}
 
 	private:
 		//- Notifies all listeners of this event by invoking their callback functions.
 		virtual void Raise() const final override
 		{
-			for (u32 i = 0; i < listeners.size(); i++)
+			Notify(*static_cast<const derived*>(this));
+		}
+
+		//- Returns the queued instances of the derived class event.
+		static detail::EventChannel<derived>& GetChannel()
+		{
+			static detail::EventChannel<derived> channel;
+			return channel;
+		}
+
+		//- Invokes the callbacks of all listeners with the event.
+		//- Listeners subscribed by a callback will not receive the event currently being raised.
+		static void Notify(const derived& e)
+		{
+			raiseDepth++;
+
+			const u32 count = listeners.size();
+			for (u32 i = 0; i < count; i++)
 			{
-				if (listeners[i]->callback)
+				auto listener = listeners[i];
+				if (listener != nullptr && listener->callback)
 				{
-					listeners[i]->callback(*static_cast<const derived*>(this));
+					listener->callback(e);
 				}
 			}
+
+			raiseDepth--;
+			if (raiseDepth == 0 && numRemoved > 0)
+			{
+				Compact();
+			}
 		}
 
 		//- Subscribes a listener to receive callbacks from this type of event.
 		static void Subscribe(Listener<derived>& listener)
 		{
+			listener.slot = listeners.size();
 			listeners.push_back(&listener);
 		}
 
 		//- Stops a listener from receiving callbacks from this type of event.
 		static void Unsubscribe(Listener<derived>& listener)
 		{
-			listeners.erase(std::find(listeners.begin(), listeners.end(), &listener));
+			ASSERT(listeners[listener.slot] == &listener, "Listener is not subscribed.");
+
+			// The list cannot be reordered while it is being iterated, so leave an empty entry to be removed later.
+			if (raiseDepth > 0)
+			{
+				listeners[listener.slot] = nullptr;
+				numRemoved++;
+				return;
+			}
+
+			// Otherwise, move the last listener into the vacated slot.
+			auto last = listeners.back();
+			last->slot = listener.slot;
+			listeners[listener.slot] = last;
+			listeners.pop_back();
+		}
+
+		//- Removes the empty entries left behind by listeners which were unsubscribed during a Raise().
+		static void Compact()
+		{
+			u32 count = 0;
+			for (u32 i = 0; i < listeners.size(); i++)
+			{
+				if (auto listener = listeners[i])
+				{
+					listener->slot = count;
+					listeners[count++] = listener;
+				}
+			}
+
+			listeners.resize(count);
+			numRemoved = 0;
 		}
 
 		//- All Listeners of the derived class event.
 		static std::vector<Listener<derived>*> listeners;
+		//- The number of null entries in the listeners vector.
+		static u32 numRemoved;
+		//- The number of nested calls to Notify() in progress.
+		static u32 raiseDepth;
 	};
 	template<class derived> std::vector<Listener<derived>*> Event<derived>::listeners;
-	
+	template<class derived> u32 Event<derived>::numRemoved = 0;
+	template<class derived> u32 Event<derived>::raiseDepth = 0;
+
+	namespace detail
+	{
+		//- The queued events of a single type.
+		class EventChannelBase
+		{
+		public:
+			virtual ~EventChannelBase() = default;
+
+			//- Delivers the oldest 'count' queued events to the listeners of their type, in the order that they were pushed.
+			virtual void Dispatch(u32 count) = 0;
+		};
+
+		//- Stores the queued events of one type by value, so that queuing them doesn't allocate.
+		template<class EventObj>
+		class EventChannel : public EventChannelBase
+		{
+		public:
+			virtual void Dispatch(u32 count) final override
+			{
+				for (u32 i = 0; i < count; ++i)
+				{
+					EventObj::Notify(events.Front());
+					events.PopFront();
+				}
+			}
+
+			RingBuffer<EventObj> events;
+		};
+
+		//- A sequence of consecutive events of the same type, waiting in the EventQueue.
+		struct EventRun
+		{
+			EventChannelBase* channel;
+			u32 count;
+		};
+
+		//- An event posted through EventQueue.Post(), waiting to be moved into the channel for its type.
+		class PostedEventBase
+		{
+		public:
+			virtual ~PostedEventBase() = default;
+
+			//- Moves the event into the queue.
+			virtual void Push() = 0;
+
+			//- The previously posted event.
+			PostedEventBase* next = nullptr;
+		};
+
+		template<class EventObj>
+		class PostedEvent final : public PostedEventBase
+		{
+		public:
+			template<typename... Args>
+			PostedEvent(Args&&... args)
+				: event(std::forward<Args>(args)...)
+			{
+			}
+
+			virtual void Push() override;
+
+			EventObj event;
+		};
+	}
+
 	//- This singleton class handles queuing and distribution of events.
 	static class EventQueue : public Singleton<class EventQueue>
 	{
 	public:
-		//- Add a new event to the queue.
+		//- Constructs a new event in the queue from the arguments. For example:
+		//	EventQueue.Push<KeyPressed>(Key::Space);
 		//- The event will be distributed to all listeners of its type when Dispatch() is called.
-		void Push(std::unique_ptr<EventBase> e);
+		//- Events are stored by value in a buffer for their type, which is reused every frame.
+		//- Events pushed while Dispatch() is executing are delivered by the next call to Dispatch().
+		//! Only call this from the main thread. Use Post() from other threads.
+		template<class EventObj, typename... Args>
+		void Push(Args&&... args)
+		{
+			static_assert(std::is_base_of<Event<EventObj>, EventObj>::value, "Template argument must inherit from Event.");
+
+			if (inDispatch)
+			{
+				Post<EventObj>(std::forward<Args>(args)...);
+				return;
+			}
+
+			if (!EventObj::HasListenersStatic())
+			{
+				return;
+			}
+
+			auto& channel = EventObj::GetChannel();
+			channel.events.Emplace(std::forward<Args>(args)...);
+
+			// Consecutive events of the same type are batched into a single run.
+			if (!pendingRuns.empty() && pendingRuns.back().channel == &channel)
+			{
+				pendingRuns.back().count++;
+			}
+			else
+			{
+				pendingRuns.push_back({ &channel, 1 });
+			}
+		}
+
+		//- Constructs a new event from the arguments and adds it to the queue. This is thread-safe and lock-free.
+		//- Posted events are moved into the queue by the next call to Dispatch(), on the main thread.
+		//  Events posted by each thread are delivered in the order that they were posted.
+		//- Unlike Push(), each posted event is allocated individually until it reaches the queue.
+		template<class EventObj, typename... Args>
+		void Post(Args&&... args)
+		{
+			static_assert(std::is_base_of<Event<EventObj>, EventObj>::value, "Template argument must inherit from Event.");
+
+			auto posted = new detail::PostedEvent<EventObj>(std::forward<Args>(args)...);
+			posted->next = postedEvents.load(std::memory_order_relaxed);
+			while (!postedEvents.compare_exchange_weak(posted->next, posted, std::memory_order_release, std::memory_order_relaxed))
+			{
+				// Another thread posted first. 'posted->next' now holds the new top of the stack, so try again.
+			}
+		}
 
 		//- Instantly distributes an event across listeners. It is not added to the queue.
 		void Dispatch(const EventBase& e) const;
 
 		//- Sequences through the queue of events and distributes them to all the listeners.
-		//- There will be no events in the queue when this function returns.
-		//- It is illegal, and unsafe, to post new events while this function is executing.
+		//- Events are delivered in the order that they were pushed. Consecutive events of the same type are
+		//  delivered together, straight from the buffer for their type.
+		//- Events posted from other threads are first moved into the queue, after the events pushed directly.
+		//- Events pushed or posted while this function is executing are held until the next call.
+		//! Only call this from the main thread.
 		void Dispatch();
 
+		~EventQueue();
+
 	private:
-		std::queue<std::unique_ptr<EventBase>> eventQueue;
+		//- Moves posted events into the queue, in the order that they were posted.
+		void PushPostedEvents();
+
+		//- The queued events, as runs of the same type in the order that they were pushed.
+		std::vector<detail::EventRun> pendingRuns;
+
+		//- The most recently posted event, forming a lock-free stack with the ones posted before it.
+		std::atomic<detail::PostedEventBase*> postedEvents{ nullptr };
 
-#ifdef _DEBUG
-		//- Debug flag to stop events from being queued during a call to Dispatch().
+		//- Whether Dispatch() is executing. New events are deferred until the next Dispatch() while this is set.
 		bool inDispatch = false;
-#endif
 	} &EventQueue = Singleton<class EventQueue>::instanceRef;
+
+	template<class EventObj>
+	void detail::PostedEvent<EventObj>::Push()
+	{
+		EventQueue.Push<EventObj>(std::move(event));
+	}
 }
@@ -433,4 +433,83 @@ namespace Jwl
 	{
 		return length;
 	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	bool MappedFile::operator!() const
+	{
+		return data == nullptr;
+	}
+
+	bool MappedFile::Open(const std::string& filePath)
+	{
+		ASSERT(!(*this), "MappedFile: Already associated with a file.");
+
+		HANDLE fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		file = fileHandle;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0 || fileSize.HighPart != 0)
+		{
+			Close();
+			return false;
+		}
+		size = static_cast<u32>(fileSize.QuadPart);
+
+		mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		data = static_cast<const u8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		if (data == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (data != nullptr)
+		{
+			UnmapViewOfFile(data);
+			data = nullptr;
+		}
+
+		if (mapping != nullptr)
+		{
+			CloseHandle(mapping);
+			mapping = nullptr;
+		}
+
+		if (file != nullptr)
+		{
+			CloseHandle(file);
+			file = nullptr;
+		}
+
+		size = 0;
+	}
+
+	const u8* MappedFile::GetData() const
+	{
+		return data;
+	}
+
+	u32 MappedFile::GetSize() const
+	{
+		return size;
+	}
 }
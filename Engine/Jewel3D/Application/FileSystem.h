@@ -114,4 +114,34 @@ namespace Jwl
 		u32 currentPos = 0;
 		u32 length = 0;
 	};
+
+	//- Maps a file into memory for reading, without copying it.
+	//- The contents are paged in by the operating system as they are accessed, which is much faster
+	//  than reading the file through a stream when it is large.
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile();
+
+		bool operator!() const;
+
+		//- Maps the contents of the file into memory.
+		bool Open(const std::string& filePath);
+		//- Unmaps the file. Any pointers to its data become invalid.
+		void Close();
+
+		//- Returns the contents of the file.
+		const u8* GetData() const;
+		//- Returns the size of the file in bytes.
+		u32 GetSize() const;
+
+	private:
+		void* file = nullptr;
+		void* mapping = nullptr;
+		const u8* data = nullptr;
+		u32 size = 0;
+	};
 }
@@ -2,40 +2,77 @@
 #pragma once
 #include "Jewel3D/Application/Event.h"
 #include "Jewel3D/Entity/Entity.h"
+#include "Jewel3D/Utilities/InlineFunction.h"
+
+#include <vector>
 
 namespace Jwl
 {
+	template<class EventObj> class EventDispatcher;
+
 	//- Responds to events given from an EventDispatcher component higher in the hierarchy.
 	template<class EventObj>
 	class ProxyListener : public Component<ProxyListener<EventObj>>
 	{
 		static_assert(std::is_base_of<EventBase, EventObj>::value, "Template argument must inherit from Event.");
+		friend EventDispatcher<EventObj>;
 	public:
 		ProxyListener(Entity& owner)
-			: Component(owner)
+			: Component<ProxyListener<EventObj>>(owner)
+		{
+			owner.MarkSubtreeChanged();
+		}
+
+		ProxyListener& operator=(const ProxyListener& other)
+		{
+			callback = other.callback;
+			return *this;
+		}
+
+		~ProxyListener()
 		{
+			this->owner.MarkSubtreeChanged();
 		}
 
 		//- Your function should return 'true' if the event is handled,
 		//  This will cause it to stop propagating down the hierarchy.
-		std::function<bool(const EventObj&)> callback;
+		InlineFunction<bool(const EventObj&)> callback;
+
+	private:
+		//- Changes to the set of active listeners are signaled to the EventDispatchers above.
+		virtual void OnEnable() final override { this->owner.MarkSubtreeChanged(); }
+		virtual void OnDisable() final override { this->owner.MarkSubtreeChanged(); }
+
+		//- The last event received, to avoid notifying the listener twice if propagation is interrupted.
+		u64 lastEventId = 0;
 	};
 
 	//- Propagates an event through a hierarchy of Entities.
+	//- The active ProxyListeners below the dispatcher are cached in the order that they are notified.
+	//  The list is only rebuilt when the subtree changes, so propagating an event doesn't search the hierarchy.
 	template<class EventObj>
 	class EventDispatcher : public Component<EventDispatcher<EventObj>>
 	{
 		static_assert(std::is_base_of<EventBase, EventObj>::value, "Template argument must inherit from Event.");
 	public:
 		EventDispatcher(Entity& owner)
-			: Component(owner)
+			: Component<EventDispatcher<EventObj>>(owner)
 		{
 			OnEnable();
 		}
 
+		EventDispatcher(const EventDispatcher&) = delete;
+
+		//- Each dispatcher distributes events to its own subtree, so there is no state to copy.
+		EventDispatcher& operator=(const EventDispatcher& other)
+		{
+			Component<EventDispatcher<EventObj>>::operator=(other);
+			return *this;
+		}
+
 		virtual void OnEnable() final override
 		{
-			listener.callback = [owner](auto& e) { Distribute(owner, e); };
+			listener.callback = [this](const EventObj& e) { Distribute(e); };
 		}
 
 		virtual void OnDisable() final override
@@ -44,34 +81,97 @@ namespace Jwl
 		}
 
 	private:
-		//- Propagates the event through the hierarchy, breadth first, notifying ProxyListeners.
-		//- Once a listener has handled the event by returning true from it's callback, propagation stops.
-		static bool Distribute(Entity& ent, const EventObj& e)
+		//- Propagates the event through the hierarchy, notifying the ProxyListeners of the children before
+		//  those of their descendants. Once a listener has handled the event by returning true from its
+		//  callback, propagation stops.
+		bool Distribute(const EventObj& e)
 		{
-			auto& children = ent.GetChildren();
+			const u64 eventId = ++eventCounter;
 
-			for (u32 i = 0; i < children.size(); i++)
+			if (cachedVersion != this->owner.GetSubtreeVersion() || !isCached)
 			{
-				if (auto comp = children[i]->owner.GetComponent<ProxyListener<EventObj>>())
-				{
-					if (comp->callback && comp->callback(e))
-					{
-						return true;
-					}
-				}
+				Rebuild();
 			}
 
-			for (u32 i = 0; i < children.size(); i++)
+			u32 i = 0;
+			while (i < proxies.size())
 			{
-				if (Distribute(children[i]->owner, e))
+				auto proxy = proxies[i];
+				if (proxy->lastEventId == eventId)
+				{
+					i++;
+					continue;
+				}
+
+				proxy->lastEventId = eventId;
+				if (proxy->callback && proxy->callback(e))
 				{
 					return true;
 				}
+
+				// The callback might have changed the subtree. If so, continue with an up to date list,
+				// skipping the listeners which have already received the event.
+				if (cachedVersion != this->owner.GetSubtreeVersion())
+				{
+					Rebuild();
+					i = 0;
+				}
+				else
+				{
+					i++;
+				}
 			}
 
 			return false;
 		}
 
+		void Rebuild()
+		{
+			proxies.clear();
+
+			// Expanding the children of each node together, before descending into them one by one,
+			// notifies siblings together. The stack is reused between rebuilds to avoid allocating.
+			expansionStack.clear();
+			expansionStack.push_back(&this->owner);
+			while (!expansionStack.empty())
+			{
+				Entity* node = expansionStack.back();
+				expansionStack.pop_back();
+
+				auto& children = node->GetChildren();
+				for (auto& child : children)
+				{
+					auto proxy = child->Try<ProxyListener<EventObj>>();
+					if (proxy && proxy->IsEnabled())
+					{
+						proxies.push_back(proxy);
+					}
+				}
+
+				for (u32 i = children.size(); i-- > 0;)
+				{
+					expansionStack.push_back(children[i].get());
+				}
+			}
+
+			cachedVersion = this->owner.GetSubtreeVersion();
+			isCached = true;
+
+			// Further changes to the subtree must update its version again.
+			this->owner.ClearSubtreeChanged();
+		}
+
 		Listener<EventObj> listener;
+
+		//- The active ProxyListeners below this dispatcher, in the order that they are notified.
+		std::vector<ProxyListener<EventObj>*> proxies;
+		std::vector<Entity*> expansionStack;
+		u32 cachedVersion = 0;
+		bool isCached = false;
+
+		//- Identifies each event as it is propagated.
+		static u64 eventCounter;
 	};
+
+	template<class EventObj> u64 EventDispatcher<EventObj>::eventCounter = 0;
 }
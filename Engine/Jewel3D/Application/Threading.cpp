@@ -34,6 +34,37 @@ namespace Jwl
 
 	//-----------------------------------------------------------------------------------------------------
 
+	Semaphore::~Semaphore()
+	{
+		if (semaphore != NULL)
+		{
+			CloseHandle(semaphore);
+		}
+	}
+
+	bool Semaphore::Init(u32 initialCount)
+	{
+		semaphore = CreateSemaphore(
+			NULL,			// Default security
+			initialCount,	// Initial count
+			LONG_MAX,		// Maximum count
+			NULL);			// Unnamed
+
+		return semaphore != NULL;
+	}
+
+	void Semaphore::Wait()
+	{
+		WaitForSingleObject(semaphore, INFINITE);
+	}
+
+	void Semaphore::Signal(u32 count)
+	{
+		ReleaseSemaphore(semaphore, count, NULL);
+	}
+
+	//-----------------------------------------------------------------------------------------------------
+
 	Thread::~Thread()
 	{
 		if (threadHandle != NULL)
@@ -21,6 +21,24 @@ namespace Jwl
 		HANDLE mutex = 0;
 	};
 
+	//- Maintains a count which threads can wait on. Useful for waking up sleeping threads.
+	class Semaphore
+	{
+	public:
+		~Semaphore();
+
+		bool Init(u32 initialCount = 0);
+
+		//- Blocks until the count is above zero, then decrements it.
+		void Wait();
+
+		//- Increments the count, allowing as many waiting threads to proceed.
+		void Signal(u32 count = 1);
+
+	private:
+		HANDLE semaphore = 0;
+	};
+
 	class Thread
 	{
 	public:
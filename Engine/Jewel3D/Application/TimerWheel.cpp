@@ -0,0 +1,244 @@
+// Copyright (c) 2017 Emilian Cioca
+#include "Jewel3D/Precompiled.h"
+#include "TimerWheel.h"
+
+namespace Jwl
+{
+	constexpr u32 TimerWheel::InvalidIndex;
+	constexpr u32 TimerWheel::NumLevels;
+	constexpr u32 TimerWheel::SlotBits;
+	constexpr u32 TimerWheel::NumSlots;
+	constexpr u32 TimerWheel::SlotMask;
+
+	TimerWheel::TimerWheel()
+	{
+		for (u32& slot : slots)
+		{
+			slot = InvalidIndex;
+		}
+	}
+
+	TimerHandle TimerWheel::Schedule(u32 delay, Callback callback)
+	{
+		return Add(delay, 0, std::move(callback));
+	}
+
+	TimerHandle TimerWheel::ScheduleRepeating(u32 interval, Callback callback)
+	{
+		ASSERT(interval > 0, "The interval of a repeating timer must be at least 1 tick.");
+
+		return Add(interval, interval, std::move(callback));
+	}
+
+	bool TimerWheel::Cancel(TimerHandle handle)
+	{
+		if (!IsScheduled(handle))
+		{
+			return false;
+		}
+
+		Entry& entry = entries[handle.index];
+		entry.isScheduled = false;
+
+		// A timer which is firing is released once its callback returns.
+		if (entry.slot != InvalidIndex)
+		{
+			Unlink(handle.index);
+			Release(handle.index);
+		}
+
+		return true;
+	}
+
+	bool TimerWheel::IsScheduled(TimerHandle handle) const
+	{
+		return handle.index < entries.size() &&
+			entries[handle.index].generation == handle.generation &&
+			entries[handle.index].isScheduled;
+	}
+
+	u32 TimerWheel::GetRemainingTicks(TimerHandle handle) const
+	{
+		if (!IsScheduled(handle))
+		{
+			return 0;
+		}
+
+		const Entry& entry = entries[handle.index];
+
+		// A repeating timer which is firing will be rescheduled for its next interval.
+		if (entry.slot == InvalidIndex)
+		{
+			return entry.interval;
+		}
+
+		return static_cast<u32>(entry.expiry - currentTick);
+	}
+
+	void TimerWheel::Advance(u32 ticks)
+	{
+		for (u32 i = 0; i < ticks; ++i)
+		{
+			Tick();
+		}
+	}
+
+	void TimerWheel::Clear()
+	{
+		for (u32 i = 0; i < entries.size(); ++i)
+		{
+			Entry& entry = entries[i];
+			if (entry.isScheduled)
+			{
+				entry.isScheduled = false;
+
+				if (entry.slot != InvalidIndex)
+				{
+					Unlink(i);
+					Release(i);
+				}
+			}
+		}
+	}
+
+	TimerHandle TimerWheel::Add(u32 delay, u32 interval, Callback callback)
+	{
+		ASSERT(callback, "A timer must have a callback.");
+
+		u32 index;
+		if (freeList != InvalidIndex)
+		{
+			index = freeList;
+			freeList = entries[index].next;
+		}
+		else
+		{
+			index = entries.size();
+			entries.emplace_back();
+		}
+
+		Entry& entry = entries[index];
+		entry.callback = std::move(callback);
+		entry.expiry = currentTick + (delay == 0 ? 1 : delay);
+		entry.interval = interval;
+		entry.isScheduled = true;
+
+		Insert(index);
+		numTimers++;
+
+		return TimerHandle(index, entry.generation);
+	}
+
+	void TimerWheel::Release(u32 index)
+	{
+		Entry& entry = entries[index];
+		entry.callback.Reset();
+		entry.generation++;
+		entry.prev = InvalidIndex;
+		entry.next = freeList;
+		freeList = index;
+
+		numTimers--;
+	}
+
+	void TimerWheel::Insert(u32 index)
+	{
+		Entry& entry = entries[index];
+		const u64 delta = entry.expiry - currentTick;
+
+		// Choose the lowest wheel whose range covers the delay.
+		u32 level = 0;
+		while (level < NumLevels - 1 && delta >= (1ull << (SlotBits * (level + 1))))
+		{
+			level++;
+		}
+
+		const u32 slot = level * NumSlots + static_cast<u32>((entry.expiry >> (SlotBits * level)) & SlotMask);
+
+		entry.slot = slot;
+		entry.prev = InvalidIndex;
+		entry.next = slots[slot];
+		if (entry.next != InvalidIndex)
+		{
+			entries[entry.next].prev = index;
+		}
+		slots[slot] = index;
+	}
+
+	void TimerWheel::Unlink(u32 index)
+	{
+		Entry& entry = entries[index];
+
+		if (entry.prev != InvalidIndex)
+		{
+			entries[entry.prev].next = entry.next;
+		}
+		else
+		{
+			slots[entry.slot] = entry.next;
+		}
+
+		if (entry.next != InvalidIndex)
+		{
+			entries[entry.next].prev = entry.prev;
+		}
+
+		entry.prev = InvalidIndex;
+		entry.next = InvalidIndex;
+		entry.slot = InvalidIndex;
+	}
+
+	void TimerWheel::Cascade(u32 level, u32 slotIndex)
+	{
+		const u32 slot = level * NumSlots + slotIndex;
+
+		u32 index = slots[slot];
+		slots[slot] = InvalidIndex;
+
+		while (index != InvalidIndex)
+		{
+			const u32 next = entries[index].next;
+			Insert(index);
+			index = next;
+		}
+	}
+
+	void TimerWheel::Tick()
+	{
+		currentTick++;
+
+		// When a wheel completes a turn, the next slot of the wheel above is redistributed into the lower wheels.
+		for (u32 level = 1; level < NumLevels; ++level)
+		{
+			if ((currentTick & ((1ull << (SlotBits * level)) - 1)) != 0)
+			{
+				break;
+			}
+
+			Cascade(level, static_cast<u32>((currentTick >> (SlotBits * level)) & SlotMask));
+		}
+
+		// Fire the timers due on this tick. The callbacks might schedule or cancel other timers,
+		// so the slot is consumed one timer at a time rather than iterated.
+		u32& head = slots[currentTick & SlotMask];
+		while (head != InvalidIndex)
+		{
+			const u32 index = head;
+			Unlink(index);
+
+			Entry& entry = entries[index];
+			entry.callback();
+
+			if (entry.isScheduled && entry.interval > 0)
+			{
+				entry.expiry = currentTick + entry.interval;
+				Insert(index);
+			}
+			else
+			{
+				entry.isScheduled = false;
+				Release(index);
+			}
+		}
+	}
+}
@@ -0,0 +1,148 @@
+// Copyright (c) 2017 Emilian Cioca
+#pragma once
+#include "Jewel3D/Application/Event.h"
+#include "Jewel3D/Application/Types.h"
+#include "Jewel3D/Utilities/InlineFunction.h"
+#include "Jewel3D/Utilities/Singleton.h"
+
+#include <deque>
+#include <utility>
+
+namespace Jwl
+{
+	//- Refers to a timer scheduled with a TimerWheel. Remains safe to use after the timer is gone.
+	class TimerHandle
+	{
+		friend class TimerWheel;
+	public:
+		TimerHandle() = default;
+
+		bool operator==(const TimerHandle& other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const TimerHandle& other) const { return !(*this == other); }
+
+	private:
+		TimerHandle(u32 _index, u32 _generation)
+			: index(_index), generation(_generation)
+		{}
+
+		u32 index = ~0u;
+		u32 generation = 0;
+	};
+
+	//- Schedules callbacks to be invoked after a delay, or repeatedly on an interval. Time is measured in ticks.
+	//- Timers are sorted into a hierarchy of four wheels of 256 slots, each wheel covering 256 times the range of the one
+	//  below it. Scheduling and cancelling are O(1), and advancing only touches the timers which expire on that tick,
+	//  except for the occasional redistribution of one slot from a higher wheel as the lower wheel completes a turn.
+	class TimerWheel
+	{
+	public:
+		using Callback = InlineFunction<void()>;
+
+		TimerWheel();
+		TimerWheel(const TimerWheel&) = delete;
+		TimerWheel& operator=(const TimerWheel&) = delete;
+
+		//- Invokes the callback once, after the specified number of ticks. A delay of 0 is treated as 1.
+		TimerHandle Schedule(u32 delay, Callback callback);
+
+		//- Invokes the callback every 'interval' ticks, starting 'interval' ticks from now, until cancelled.
+		TimerHandle ScheduleRepeating(u32 interval, Callback callback);
+
+		//- Pushes a copy of the event to the EventQueue after the specified number of ticks.
+		template<class EventObj, typename... Args>
+		TimerHandle ScheduleEvent(u32 delay, Args&&... args);
+
+		//- Pushes a copy of the event to the EventQueue every 'interval' ticks, until cancelled.
+		template<class EventObj, typename... Args>
+		TimerHandle ScheduleRepeatingEvent(u32 interval, Args&&... args);
+
+		//- Stops the timer. Returns false if it had already finished or been cancelled.
+		//- Timers can be cancelled from inside of callbacks, including their own.
+		bool Cancel(TimerHandle handle);
+
+		//- Returns true if the timer is still waiting to fire.
+		bool IsScheduled(TimerHandle handle) const;
+
+		//- Returns the number of ticks until the timer next fires, or 0 if it is not scheduled.
+		u32 GetRemainingTicks(TimerHandle handle) const;
+
+		//- Moves time forward, firing the timers that expire along the way in the order of their expiry.
+		//- Timers expiring on the same tick fire in no particular order.
+		void Advance(u32 ticks = 1);
+
+		//- Cancels all timers.
+		void Clear();
+
+		u64 GetCurrentTick() const { return currentTick; }
+		u32 GetNumTimers() const { return numTimers; }
+
+	private:
+		static constexpr u32 InvalidIndex = ~0u;
+		static constexpr u32 NumLevels = 4;
+		static constexpr u32 SlotBits = 8;
+		static constexpr u32 NumSlots = 1u << SlotBits;
+		static constexpr u32 SlotMask = NumSlots - 1;
+
+		struct Entry
+		{
+			Callback callback;
+			u64 expiry = 0;
+			//- 0 for timers which only fire once.
+			u32 interval = 0;
+			u32 generation = 0;
+
+			//- Links to the neighbouring timers in the same slot.
+			u32 prev = InvalidIndex;
+			u32 next = InvalidIndex;
+			//- The slot holding the timer, or InvalidIndex if it isn't in one.
+			u32 slot = InvalidIndex;
+
+			bool isScheduled = false;
+		};
+
+		TimerHandle Add(u32 delay, u32 interval, Callback callback);
+		void Release(u32 index);
+
+		//- Places the timer in the slot corresponding to its expiry.
+		void Insert(u32 index);
+		void Unlink(u32 index);
+
+		//- Moves the timers of a slot in a higher wheel down into the lower wheels.
+		void Cascade(u32 level, u32 slotIndex);
+		void Tick();
+
+		//- A deque keeps the entries in place as it grows, so callbacks can schedule new timers while they are invoked.
+		std::deque<Entry> entries;
+		u32 freeList = InvalidIndex;
+
+		//- The first timer in each slot of each wheel.
+		u32 slots[NumLevels * NumSlots];
+
+		u64 currentTick = 0;
+		u32 numTimers = 0;
+	};
+
+	//- The TimerWheel of the game. It is advanced once per call to Application.UpdateEngine(),
+	//  just before the EventQueue is dispatched. Events scheduled with it are delivered on the tick that they fire.
+	static class TimerQueue : public TimerWheel, public Singleton<class TimerQueue>
+	{
+	} &TimerQueue = Singleton<class TimerQueue>::instanceRef;
+
+	template<class EventObj, typename... Args>
+	TimerHandle TimerWheel::ScheduleEvent(u32 delay, Args&&... args)
+	{
+		static_assert(std::is_base_of<Event<EventObj>, EventObj>::value, "Template argument must inherit from Event.");
+
+		EventObj e(std::forward<Args>(args)...);
+		return Schedule(delay, [e]() { EventQueue.Push<EventObj>(e); });
+	}
+
+	template<class EventObj, typename... Args>
+	TimerHandle TimerWheel::ScheduleRepeatingEvent(u32 interval, Args&&... args)
+	{
+		static_assert(std::is_base_of<Event<EventObj>, EventObj>::value, "Template argument must inherit from Event.");
+
+		EventObj e(std::forward<Args>(args)...);
+		return ScheduleRepeating(interval, [e]() { EventQueue.Push<EventObj>(e); });
+	}
+}
@@ -0,0 +1,188 @@
+// Copyright (c) 2017 Emilian Cioca
+#include "Jewel3D/Precompiled.h"
+#include "WorkerPool.h"
+#include "Logging.h"
+#include "Threading.h"
+
+#include <thread>
+
+namespace
+{
+	//- Set while the current thread is executing a task of the pool.
+	thread_local bool insideTask = false;
+}
+
+namespace Jwl
+{
+	WorkerPool::WorkerPool()
+		: next(0)
+		, pending(0)
+		, busy(false)
+	{
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		Shutdown();
+	}
+
+	bool WorkerPool::Init(u32 numWorkers)
+	{
+		ASSERT(!IsRunning(), "WorkerPool is already running.");
+
+		if (numWorkers == 0)
+		{
+			const u32 hardwareThreads = std::thread::hardware_concurrency();
+			numWorkers = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+		}
+
+		wake = std::make_unique<Semaphore>();
+		done = std::make_unique<Semaphore>();
+		if (!wake->Init() || !done->Init())
+		{
+			Error("WorkerPool: Failed to create synchronization objects.");
+			wake.reset();
+			done.reset();
+			return false;
+		}
+
+		exiting = false;
+		for (u32 i = 0; i < numWorkers; ++i)
+		{
+			auto thread = std::make_unique<Thread>();
+			if (!thread->Start(&WorkerMain, this))
+			{
+				Error("WorkerPool: Failed to start worker thread.");
+				Shutdown();
+				return false;
+			}
+
+			threads.push_back(std::move(thread));
+		}
+
+		return true;
+	}
+
+	void WorkerPool::Shutdown()
+	{
+		if (!wake)
+		{
+			return;
+		}
+
+		exiting = true;
+		wake->Signal(threads.size());
+
+		for (auto& thread : threads)
+		{
+			thread->Join();
+		}
+
+		threads.clear();
+		wake.reset();
+		done.reset();
+	}
+
+	void WorkerPool::ParallelFor(u32 _count, const std::function<void(u32)>& _task)
+	{
+		if (_count == 0)
+		{
+			return;
+		}
+
+		// Small loops, and loops nested inside of a task, don't benefit from a round-trip to the workers.
+		// Loops started while another thread owns the pool, such as one simulating a separate World, can't use it.
+		if (_count == 1 || insideTask || busy.exchange(true))
+		{
+			for (u32 i = 0; i < _count; ++i)
+			{
+				_task(i);
+			}
+
+			return;
+		}
+
+		if (!IsRunning())
+		{
+			Init();
+
+			if (!IsRunning())
+			{
+				busy = false;
+				for (u32 i = 0; i < _count; ++i)
+				{
+					_task(i);
+				}
+
+				return;
+			}
+		}
+
+		task = &_task;
+		count = _count;
+		next = 0;
+
+		// There is no use in waking more workers than there are tasks to share with the calling thread.
+		const u32 numWakes = std::min<u32>(threads.size(), _count - 1);
+		pending = numWakes;
+		wake->Signal(numWakes);
+
+		RunTasks();
+
+		// The loop state must not change until every woken worker has stopped looking at it.
+		if (numWakes > 0)
+		{
+			done->Wait();
+		}
+
+		task = nullptr;
+		count = 0;
+		busy = false;
+	}
+
+	u32 WorkerPool::GetNumWorkers() const
+	{
+		return threads.size();
+	}
+
+	bool WorkerPool::IsRunning() const
+	{
+		return !threads.empty();
+	}
+
+	u32 __stdcall WorkerPool::WorkerMain(void* pool)
+	{
+		auto& self = *static_cast<class WorkerPool*>(pool);
+
+		while (true)
+		{
+			self.wake->Wait();
+			if (self.exiting)
+			{
+				break;
+			}
+
+			self.RunTasks();
+
+			// Wake-ups are counted rather than workers, so it doesn't matter which thread consumed which.
+			if (--self.pending == 0)
+			{
+				self.done->Signal();
+			}
+		}
+
+		return 0;
+	}
+
+	void WorkerPool::RunTasks()
+	{
+		insideTask = true;
+
+		for (u32 i = next++; i < count; i = next++)
+		{
+			(*task)(i);
+		}
+
+		insideTask = false;
+	}
+}
@@ -0,0 +1,65 @@
+// Copyright (c) 2017 Emilian Cioca
+#pragma once
+#include "Jewel3D/Application/Types.h"
+#include "Jewel3D/Utilities/Singleton.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Jwl
+{
+	class Semaphore;
+	class Thread;
+
+	//- A set of persistent worker threads used to execute data-parallel loops.
+	//- The threads sleep until work is submitted, so an idle pool has no cost.
+	static class WorkerPool : public Singleton<class WorkerPool>
+	{
+	public:
+		WorkerPool();
+		~WorkerPool();
+
+		//- Starts the worker threads. If numWorkers is 0, one worker is created for each
+		//  hardware thread except the calling one. Returns false if the threads could not be started.
+		bool Init(u32 numWorkers = 0);
+		//- Stops all worker threads, waiting for them to exit.
+		void Shutdown();
+
+		//- Invokes task(i) for every i in [0, count), spread across the workers and the calling thread.
+		//- Returns only once every invocation has completed. Invocations may run in any order.
+		//- The pool is started automatically the first time that it is needed.
+		//- If called from inside a task, or while another thread is using the pool, the loop is
+		//  executed on the calling thread instead.
+		void ParallelFor(u32 count, const std::function<void(u32)>& task);
+
+		u32 GetNumWorkers() const;
+		bool IsRunning() const;
+
+	private:
+		static u32 __stdcall WorkerMain(void* pool);
+
+		//- Claims and executes tasks until none remain.
+		void RunTasks();
+
+		std::vector<std::unique_ptr<Thread>> threads;
+
+		//- Released once for each worker that should pick up the current loop.
+		std::unique_ptr<Semaphore> wake;
+		//- Released by the last worker to finish the current loop.
+		std::unique_ptr<Semaphore> done;
+
+		//- The current loop.
+		const std::function<void(u32)>* task = nullptr;
+		u32 count = 0;
+		//- The next index to be claimed.
+		std::atomic<u32> next;
+		//- The number of wake-ups of the current loop which have not finished yet.
+		std::atomic<u32> pending;
+		//- Set while a thread is distributing a loop to the workers.
+		std::atomic<bool> busy;
+
+		bool exiting = false;
+	} &WorkerPool = Singleton<class WorkerPool>::instanceRef;
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2017 Emilian Cioca
+#include "Jewel3D/Precompiled.h"
+#include "BlockPool.h"
+#include "Jewel3D/Application/Logging.h"
+
+#include <algorithm>
+
+namespace Jwl
+{
+	namespace detail
+	{
+		BlockPool::BlockPool(u32 blockSize, u32 _alignment)
+			// Every block must be able to hold the free list link once released.
+			: alignment(std::max<u32>(_alignment, alignof(void*)))
+			, stride((std::max<u32>(blockSize, sizeof(void*)) + alignment - 1) / alignment * alignment)
+		{
+		}
+
+		void* BlockPool::Allocate()
+		{
+			count++;
+			totalAllocations++;
+
+			if (freeList)
+			{
+				void* block = freeList;
+				freeList = *static_cast<void**>(block);
+
+				return block;
+			}
+
+			if (numUnclaimed == 0)
+			{
+				chunks.push_back(std::make_unique<u8[]>(stride * BlocksPerChunk + alignment));
+
+				auto address = reinterpret_cast<uintptr_t>(chunks.back().get());
+				nextBlock = chunks.back().get() + (alignment - address % alignment) % alignment;
+				numUnclaimed = BlocksPerChunk;
+			}
+
+			void* block = nextBlock;
+			nextBlock += stride;
+			numUnclaimed--;
+
+			return block;
+		}
+
+		void BlockPool::Release(void* block)
+		{
+			ASSERT(count > 0, "Block was released to an empty BlockPool.");
+
+			*static_cast<void**>(block) = freeList;
+			freeList = block;
+			count--;
+		}
+	}
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2017 Emilian Cioca
+#pragma once
+#include "Jewel3D/Application/Types.h"
+
+#include <memory>
+#include <vector>
+
+namespace Jwl
+{
+	namespace detail
+	{
+		//- Hands out fixed-size blocks of memory carved from larger chunks.
+		//- Released blocks are kept on an intrusive free list and reused before any new memory is
+		//  requested, so steady-state creation and destruction never touches the heap.
+		//- Chunks are only freed along with the pool.
+		class BlockPool
+		{
+		public:
+			//- The number of blocks in each chunk.
+			static constexpr u32 BlocksPerChunk = 64;
+
+			BlockPool(u32 blockSize, u32 alignment);
+			BlockPool(const BlockPool&) = delete;
+			BlockPool& operator=(const BlockPool&) = delete;
+
+			//- Returns an uninitialized block.
+			void* Allocate();
+			//- Returns a block to the pool. Anything constructed in it must have already been destroyed.
+			void Release(void* block);
+
+			//- The size, in bytes, of each block.
+			u32 GetBlockSize() const { return stride; }
+			//- The alignment, in bytes, of each block.
+			u32 GetAlignment() const { return alignment; }
+			//- The number of blocks currently handed out.
+			u32 GetCount() const { return count; }
+			//- The number of blocks that can be handed out before more memory is needed.
+			u32 GetCapacity() const { return chunks.size() * BlocksPerChunk; }
+			//- The number of chunks allocated from the heap.
+			u32 GetNumChunks() const { return chunks.size(); }
+			//- The number of blocks handed out over the lifetime of the pool.
+			u64 GetTotalAllocations() const { return totalAllocations; }
+
+		private:
+			const u32 alignment;
+			//- Distance between consecutive blocks.
+			const u32 stride;
+
+			std::vector<std::unique_ptr<u8[]>> chunks;
+			//- The start of the unclaimed blocks of the last chunk.
+			u8* nextBlock = nullptr;
+			u32 numUnclaimed = 0;
+			//- The most recently released block. Each free block stores the address of the next.
+			void* freeList = nullptr;
+
+			u32 count = 0;
+			u64 totalAllocations = 0;
+		};
+
+		//- A standard allocator drawing from a BlockPool. Requests that don't fit in a block go to the heap.
+		//- Used to pool the shared control blocks of Entity::Ptr.
+		template<class T>
+		class PoolAllocator
+		{
+			template<class U> friend class PoolAllocator;
+		public:
+			using value_type = T;
+
+			PoolAllocator(BlockPool& _pool) : pool(&_pool) {}
+			template<class U>
+			PoolAllocator(const PoolAllocator<U>& other) : pool(other.pool) {}
+
+			T* allocate(size_t n)
+			{
+				if (Fits(n))
+				{
+					return static_cast<T*>(pool->Allocate());
+				}
+
+				return static_cast<T*>(::operator new(n * sizeof(T)));
+			}
+
+			void deallocate(T* ptr, size_t n)
+			{
+				if (Fits(n))
+				{
+					pool->Release(ptr);
+				}
+				else
+				{
+					::operator delete(ptr);
+				}
+			}
+
+			template<class U>
+			bool operator==(const PoolAllocator<U>& other) const { return pool == other.pool; }
+			template<class U>
+			bool operator!=(const PoolAllocator<U>& other) const { return pool != other.pool; }
+
+		private:
+			bool Fits(size_t n) const
+			{
+				return n * sizeof(T) <= pool->GetBlockSize() && alignof(T) <= pool->GetAlignment();
+			}
+
+			BlockPool* pool;
+		};
+	}
+}
@@ -0,0 +1,135 @@
+// Copyright (c) 2017 Emilian Cioca
+#include "Jewel3D/Precompiled.h"
+#include "ComponentMap.h"
+#include "Jewel3D/Application/Logging.h"
+
+#include <algorithm>
+
+namespace Jwl
+{
+	namespace detail
+	{
+		constexpr u32 ComponentMap::InlineCapacity;
+		constexpr u32 ComponentMap::InvalidSlot;
+		constexpr u32 ComponentMap::EmptyKey;
+
+		ComponentMap::ComponentMap()
+			: keys(inlineKeys)
+			, values(inlineValues)
+		{
+			std::fill_n(inlineKeys, InlineCapacity, EmptyKey);
+			std::fill_n(inlineValues, InlineCapacity, nullptr);
+		}
+
+		void ComponentMap::Insert(u32 id, ComponentBase* comp)
+		{
+			ASSERT(id != EmptyKey, "Invalid Component ID.");
+			ASSERT(!Contains(id), "ID is already part of the ComponentMap.");
+
+			// Keep the load factor at or below 3/4 so that probe sequences stay short.
+			if ((size + 1) * 4 > capacity * 3)
+			{
+				Grow();
+			}
+
+			const u32 wrap = capacity - 1;
+			u32 i = id & wrap;
+			while (keys[i] != EmptyKey)
+			{
+				i = (i + 1) & wrap;
+			}
+
+			keys[i] = id;
+			values[i] = comp;
+			mask |= MaskBit(id);
+			size++;
+		}
+
+		void ComponentMap::Remove(u32 id)
+		{
+			u32 hole = FindSlot(id);
+			if (hole == InvalidSlot)
+			{
+				return;
+			}
+
+			keys[hole] = EmptyKey;
+			values[hole] = nullptr;
+			size--;
+
+			// Shift back any entries that were displaced past the hole, so that lookups don't terminate early.
+			const u32 wrap = capacity - 1;
+			for (u32 i = (hole + 1) & wrap; keys[i] != EmptyKey; i = (i + 1) & wrap)
+			{
+				const u32 home = keys[i] & wrap;
+
+				// The entry can stay if its home slot lies cyclically within (hole, i].
+				const bool reachable = hole <= i
+					? (hole < home && home <= i)
+					: (hole < home || home <= i);
+
+				if (!reachable)
+				{
+					keys[hole] = keys[i];
+					values[hole] = values[i];
+					keys[i] = EmptyKey;
+					values[i] = nullptr;
+					hole = i;
+				}
+			}
+
+			// The mask bit can only be cleared if no other ID shares it.
+			bool bitShared = false;
+			for (u32 i = 0; i < capacity; i++)
+			{
+				if (keys[i] != EmptyKey && MaskBit(keys[i]) == MaskBit(id))
+				{
+					bitShared = true;
+					break;
+				}
+			}
+
+			if (!bitShared)
+			{
+				mask &= ~MaskBit(id);
+			}
+		}
+
+		void ComponentMap::Grow()
+		{
+			const u32 oldCapacity = capacity;
+			auto oldKeys = std::move(heapKeys);
+			auto oldValues = std::move(heapValues);
+			u32* previousKeys = keys;
+			ComponentBase** previousValues = values;
+
+			capacity *= 2;
+			heapKeys = std::make_unique<u32[]>(capacity);
+			heapValues = std::make_unique<ComponentBase*[]>(capacity);
+			keys = heapKeys.get();
+			values = heapValues.get();
+
+			std::fill_n(keys, capacity, EmptyKey);
+			std::fill_n(values, capacity, nullptr);
+
+			// Reinsert existing entries. The mask is unaffected.
+			const u32 wrap = capacity - 1;
+			for (u32 i = 0; i < oldCapacity; i++)
+			{
+				if (previousKeys[i] == EmptyKey)
+				{
+					continue;
+				}
+
+				u32 slot = previousKeys[i] & wrap;
+				while (keys[slot] != EmptyKey)
+				{
+					slot = (slot + 1) & wrap;
+				}
+
+				keys[slot] = previousKeys[i];
+				values[slot] = previousValues[i];
+			}
+		}
+	}
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2017 Emilian Cioca
+#pragma once
+#include "Jewel3D/Application/Types.h"
+
+#include <memory>
+
+namespace Jwl
+{
+	class ComponentBase;
+
+	namespace detail
+	{
+		//- Maps Component and Tag IDs to the instances owned by a single Entity.
+		//- Lookups are constant-time and never dereference a Component to compare its ID.
+		//- A bitmask rejects most misses before the table is probed at all.
+		//- The first few entries are stored inline, so the common case never touches the heap.
+		//- Tags are stored alongside Components with a null value.
+		class ComponentMap
+		{
+		public:
+			//- The number of slots available before the table moves to the heap.
+			static constexpr u32 InlineCapacity = 8;
+
+			ComponentMap();
+			ComponentMap(const ComponentMap&) = delete;
+			ComponentMap& operator=(const ComponentMap&) = delete;
+
+			//- Adds the ID with its associated Component. The ID must not already be present.
+			void Insert(u32 id, ComponentBase* comp);
+
+			//- Removes the ID if it is present.
+			void Remove(u32 id);
+
+			//- Returns true if the ID is present.
+			bool Contains(u32 id) const
+			{
+				return FindSlot(id) != InvalidSlot;
+			}
+
+			//- Returns the Component associated with the ID, or null if it isn't present.
+			ComponentBase* Get(u32 id) const
+			{
+				const u32 slot = FindSlot(id);
+				return slot == InvalidSlot ? nullptr : values[slot];
+			}
+
+			u32 Size() const { return size; }
+
+		private:
+			static constexpr u32 InvalidSlot = ~0u;
+			//- Marks an unused slot. Component IDs start at 1.
+			static constexpr u32 EmptyKey = 0;
+
+			static u64 MaskBit(u32 id) { return 1ull << (id & 63); }
+
+			u32 FindSlot(u32 id) const
+			{
+				if ((mask & MaskBit(id)) == 0)
+				{
+					return InvalidSlot;
+				}
+
+				// Linear probing from the ID's home slot. The table is never full, so an empty slot ends the search.
+				const u32 wrap = capacity - 1;
+				for (u32 i = id & wrap;; i = (i + 1) & wrap)
+				{
+					if (keys[i] == id)
+					{
+						return i;
+					}
+
+					if (keys[i] == EmptyKey)
+					{
+						return InvalidSlot;
+					}
+				}
+			}
+
+			//- Rehashes all entries into a larger table.
+			void Grow();
+
+			//- A bit is set for every (id % 64) present in the table.
+			u64 mask = 0;
+			u32 size = 0;
+			//- Always a power of two.
+			u32 capacity = InlineCapacity;
+
+			//- The active table. Points either to the inline arrays or to the heap.
+			u32* keys;
+			ComponentBase** values;
+
+			u32 inlineKeys[InlineCapacity];
+			ComponentBase* inlineValues[InlineCapacity];
+
+			std::unique_ptr<u32[]> heapKeys;
+			std::unique_ptr<ComponentBase*[]> heapValues;
+		};
+	}
+}
@@ -0,0 +1,111 @@
+// Copyright (c) 2017 Emilian Cioca
+#include "Jewel3D/Precompiled.h"
+#include "ComponentRegistry.h"
+
+namespace Jwl
+{
+	constexpr u32 FieldCodec<std::string>::Size;
+
+	void FieldCodec<std::string>::Write(const std::string& value, std::vector<u8>& out)
+	{
+		out.insert(out.end(), value.begin(), value.end());
+	}
+
+	void FieldCodec<std::string>::Read(std::string& value, const u8* data, u32 size)
+	{
+		value.assign(reinterpret_cast<const char*>(data), size);
+	}
+
+	ComponentType::ComponentType(const std::string& _name, u32 _componentId, u32 _size, u32 _alignment, bool _isTag)
+		: name(_name)
+		, componentId(_componentId)
+		, size(_size)
+		, alignment(_alignment)
+		, isTag(_isTag)
+	{
+	}
+
+	bool ComponentType::IsFixedSize() const
+	{
+		for (auto& field : fields)
+		{
+			if (field.size == 0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	u32 ComponentType::GetRecordSize() const
+	{
+		u32 result = 0;
+		for (auto& field : fields)
+		{
+			result += field.size;
+		}
+
+		return result;
+	}
+
+	ComponentBase* ComponentType::Create(Entity& ent) const
+	{
+		return create(ent);
+	}
+
+	detail::ComponentStorage* ComponentType::GetStorage(World& world) const
+	{
+		return getStorage(world);
+	}
+
+	const ComponentType* ComponentRegistry::Find(const std::string& name) const
+	{
+		auto itr = typesByName.find(name);
+		if (itr == typesByName.end())
+		{
+			return nullptr;
+		}
+
+		return itr->second;
+	}
+
+	const ComponentType* ComponentRegistry::FindTag(u32 tagId) const
+	{
+		auto itr = tagsById.find(tagId);
+		if (itr == tagsById.end())
+		{
+			return nullptr;
+		}
+
+		return itr->second;
+	}
+
+	const std::vector<std::unique_ptr<ComponentType>>& ComponentRegistry::GetTypes() const
+	{
+		return types;
+	}
+
+	void ComponentRegistry::Clear()
+	{
+		types.clear();
+		typesByName.clear();
+		tagsById.clear();
+	}
+
+	ComponentType& ComponentRegistry::Add(std::unique_ptr<ComponentType> type)
+	{
+		ASSERT(typesByName.find(type->name) == typesByName.end(), "A type is already registered as ( %s ).", type->name.c_str());
+
+		types.push_back(std::move(type));
+		auto& result = *types.back();
+
+		typesByName[result.name] = &result;
+		if (result.isTag)
+		{
+			tagsById[result.componentId] = &result;
+		}
+
+		return result;
+	}
+}
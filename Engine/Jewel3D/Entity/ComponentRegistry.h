@@ -0,0 +1,129 @@
+// Copyright (c) 2017 Emilian Cioca
+#pragma once
+#include "Jewel3D/Entity/Entity.h"
+#include "Jewel3D/Utilities/Singleton.h"
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace Jwl
+{
+	//- Describes how a reflected field is encoded. By default, the bytes of the value are copied directly,
+	//  which suits plain data such as numbers, vectors, and quaternions.
+	//- Specialize this to support fields that own resources. std::string is supported already.
+	template<typename T>
+	struct FieldCodec
+	{
+		static_assert(std::is_standard_layout<T>::value && std::is_trivially_destructible<T>::value && !std::is_pointer<T>::value,
+			"Field type must be plain data, or have a specialization of FieldCodec<>.");
+
+		//- The encoded size of every value, or 0 if it varies.
+		static constexpr u32 Size = sizeof(T);
+
+		static void Write(const T& value, std::vector<u8>& out);
+		static void Read(T& value, const u8* data, u32 size);
+	};
+
+	template<>
+	struct FieldCodec<std::string>
+	{
+		static constexpr u32 Size = 0;
+
+		static void Write(const std::string& value, std::vector<u8>& out);
+		static void Read(std::string& value, const u8* data, u32 size);
+	};
+
+	//- A reflected member of a Component.
+	struct ComponentField
+	{
+		std::string name;
+		//- The encoded size of the field, or 0 if it varies.
+		u32 size;
+
+		std::function<void(const ComponentBase&, std::vector<u8>&)> write;
+		std::function<void(ComponentBase&, const u8*, u32)> read;
+	};
+
+	//- Describes a registered Component or Tag type, along with its reflected fields.
+	class ComponentType
+	{
+	public:
+		ComponentType(const std::string& name, u32 componentId, u32 size, u32 alignment, bool isTag);
+		ComponentType(const ComponentType&) = delete;
+		ComponentType& operator=(const ComponentType&) = delete;
+
+		//- Reflects a data member of the Component.
+		template<class Owner, typename T>
+		ComponentType& Field(const std::string& name, T Owner::*member);
+
+		//- Reflects a property of the Component, accessed through a getter and a setter.
+		template<class Owner, typename T>
+		ComponentType& Field(const std::string& name, const T& (Owner::*getter)() const, void (Owner::*setter)(const T&));
+
+		//- Returns true if every field has a fixed size. The instances of such types are encoded as
+		//  fixed-size records, which can be decoded straight from memory without any parsing.
+		bool IsFixedSize() const;
+		//- The size of each encoded instance, if IsFixedSize().
+		u32 GetRecordSize() const;
+
+		//- Adds a default-constructed instance to the Entity. Returns null for Tags.
+		ComponentBase* Create(Entity& ent) const;
+		//- Returns the storage holding the instances of the type in the World. Returns null for Tags.
+		detail::ComponentStorage* GetStorage(World& world) const;
+
+		//- The unique name identifying the type in serialized data.
+		const std::string name;
+		const u32 componentId;
+		const u32 size;
+		const u32 alignment;
+		const bool isTag;
+
+		std::vector<ComponentField> fields;
+
+	private:
+		friend class ComponentRegistry;
+
+		ComponentBase* (*create)(Entity&) = nullptr;
+		detail::ComponentStorage* (*getStorage)(World&) = nullptr;
+	};
+
+	//- Holds the reflection data of every Component and Tag type that can be serialized.
+	//- Types are registered once at startup. For example:
+	//	ComponentRegistry.Register<Health>("Health")
+	//		.Field("current", &Health::current)
+	//		.Field("max", &Health::max);
+	//- Types deriving indirectly from Component<> can be registered as well, since each concrete type is tracked separately.
+	//! Registration is not thread-safe. It should be done before any scenes are saved or loaded.
+	static class ComponentRegistry : public Singleton<class ComponentRegistry>
+	{
+	public:
+		//- Registers the type under a unique name, which identifies it in serialized data.
+		//- Components must be constructible with just an Entity reference.
+		template<class T>
+		ComponentType& Register(const std::string& name);
+
+		//- Returns the type registered under the name, or null.
+		const ComponentType* Find(const std::string& name) const;
+		//- Returns the registered Tag with the ID, or null.
+		const ComponentType* FindTag(u32 tagId) const;
+
+		const std::vector<std::unique_ptr<ComponentType>>& GetTypes() const;
+
+		//- Unregisters every type.
+		void Clear();
+
+	private:
+		ComponentType& Add(std::unique_ptr<ComponentType> type);
+
+		std::vector<std::unique_ptr<ComponentType>> types;
+		std::unordered_map<std::string, ComponentType*> typesByName;
+		std::unordered_map<u32, ComponentType*> tagsById;
+	} &ComponentRegistry = Singleton<class ComponentRegistry>::instanceRef;
+}
+
+#include "ComponentRegistry.inl"
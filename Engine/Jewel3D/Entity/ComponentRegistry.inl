@@ -0,0 +1,100 @@
+// Copyright (c) 2017 Emilian Cioca
+namespace Jwl
+{
+	namespace detail
+	{
+		template<class T>
+		ComponentBase* CreateComponent(Entity& ent, std::false_type /* isTag */)
+		{
+			return &ent.Add<T>();
+		}
+
+		template<class T>
+		ComponentBase* CreateComponent(Entity& ent, std::true_type /* isTag */)
+		{
+			ent.Tag<T>();
+			return nullptr;
+		}
+
+		template<class T>
+		ComponentStorage* GetComponentStorage(World& world, std::false_type /* isTag */)
+		{
+			return &world.GetStorage<T>();
+		}
+
+		template<class T>
+		ComponentStorage* GetComponentStorage(World&, std::true_type /* isTag */)
+		{
+			return nullptr;
+		}
+	}
+
+	template<typename T>
+	void FieldCodec<T>::Write(const T& value, std::vector<u8>& out)
+	{
+		const u8* bytes = reinterpret_cast<const u8*>(&value);
+		out.insert(out.end(), bytes, bytes + sizeof(T));
+	}
+
+	template<typename T>
+	void FieldCodec<T>::Read(T& value, const u8* data, u32)
+	{
+		std::memcpy(&value, data, sizeof(T));
+	}
+
+	template<class Owner, typename T>
+	ComponentType& ComponentType::Field(const std::string& fieldName, T Owner::*member)
+	{
+		static_assert(std::is_base_of<ComponentBase, Owner>::value, "Fields must be members of a Component.");
+		ASSERT(!isTag, "Tags cannot have fields.");
+
+		ComponentField field;
+		field.name = fieldName;
+		field.size = FieldCodec<T>::Size;
+		field.write = [member](const ComponentBase& comp, std::vector<u8>& out) {
+			FieldCodec<T>::Write(static_cast<const Owner&>(comp).*member, out);
+		};
+		field.read = [member](ComponentBase& comp, const u8* data, u32 length) {
+			FieldCodec<T>::Read(static_cast<Owner&>(comp).*member, data, length);
+		};
+
+		fields.push_back(std::move(field));
+		return *this;
+	}
+
+	template<class Owner, typename T>
+	ComponentType& ComponentType::Field(const std::string& fieldName, const T& (Owner::*getter)() const, void (Owner::*setter)(const T&))
+	{
+		static_assert(std::is_base_of<ComponentBase, Owner>::value, "Fields must be properties of a Component.");
+		ASSERT(!isTag, "Tags cannot have fields.");
+
+		ComponentField field;
+		field.name = fieldName;
+		field.size = FieldCodec<T>::Size;
+		field.write = [getter](const ComponentBase& comp, std::vector<u8>& out) {
+			FieldCodec<T>::Write((static_cast<const Owner&>(comp).*getter)(), out);
+		};
+		field.read = [setter](ComponentBase& comp, const u8* data, u32 length) {
+			T value;
+			FieldCodec<T>::Read(value, data, length);
+			(static_cast<Owner&>(comp).*setter)(value);
+		};
+
+		fields.push_back(std::move(field));
+		return *this;
+	}
+
+	template<class T>
+	ComponentType& ComponentRegistry::Register(const std::string& name)
+	{
+		static_assert(std::is_base_of<ComponentBase, T>::value, "Template argument must inherit from Component.");
+
+		using IsTag = typename std::is_base_of<TagBase, T>::type;
+
+		auto type = std::make_unique<ComponentType>(name, T::GetComponentId(), sizeof(T), alignof(T), IsTag::value);
+		type->create = [](Entity& ent) { return detail::CreateComponent<T>(ent, IsTag()); };
+		type->getStorage = [](World& world) { return detail::GetComponentStorage<T>(world, IsTag()); };
+
+		return Add(std::move(type));
+	}
+}
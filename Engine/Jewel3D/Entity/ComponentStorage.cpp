@@ -0,0 +1,71 @@
+// Copyright (c) 2017 Emilian Cioca
+#include "Jewel3D/Precompiled.h"
+#include "ComponentStorage.h"
+#include "Jewel3D/Application/Logging.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace Jwl
+{
+	namespace detail
+	{
+		u32 NextStorageTypeIndex()
+		{
+			// Worlds on different threads may use a type for the first time simultaneously.
+			static std::atomic<u32> counter(0);
+			return counter++;
+		}
+
+		ComponentStorage::ComponentStorage(u32 _componentId, u32 size, u32 _alignment, s32 _baseOffset)
+			: componentId(_componentId)
+			, stride((size + _alignment - 1) / _alignment * _alignment)
+			, baseOffset(_baseOffset)
+			, alignment(_alignment)
+			, chunkCapacity(std::max(ChunkBytes / stride, 1u))
+		{
+		}
+
+		u32 ComponentStorage::Allocate()
+		{
+			count++;
+			totalAllocations++;
+
+			// Fill holes left by removed components first to keep the chunks dense.
+			if (!freeSlots.empty())
+			{
+				u32 slot = freeSlots.back();
+				freeSlots.pop_back();
+
+				return slot;
+			}
+
+			if (chunks.empty() || chunks.back().size == chunkCapacity)
+			{
+				Chunk chunk;
+				chunk.memory = std::make_unique<u8[]>(stride * chunkCapacity + alignment + chunkCapacity);
+
+				// Align the start of the chunk for the stored type. The activity flags trail the instances.
+				auto address = reinterpret_cast<uintptr_t>(chunk.memory.get());
+				chunk.data = chunk.memory.get() + (alignment - address % alignment) % alignment;
+				chunk.active = chunk.data + stride * chunkCapacity;
+
+				chunks.push_back(std::move(chunk));
+			}
+
+			auto& chunk = chunks.back();
+			chunk.active[chunk.size] = 0;
+
+			return (chunks.size() - 1) * chunkCapacity + chunk.size++;
+		}
+
+		void ComponentStorage::Release(u32 slot)
+		{
+			ASSERT(count > 0, "Slot was released from an empty ComponentStorage.");
+
+			SetActive(slot, false);
+			freeSlots.push_back(slot);
+			count--;
+		}
+	}
+}
@@ -0,0 +1,115 @@
+// Copyright (c) 2017 Emilian Cioca
+#pragma once
+#include "Jewel3D/Application/Types.h"
+
+#include <memory>
+#include <vector>
+
+namespace Jwl
+{
+	class ComponentBase;
+
+	namespace detail
+	{
+		//- Contiguous storage for every instance of a single concrete Component type.
+		//- Instances are packed into fixed-size chunks so that queries can sweep them linearly.
+		//- Components never move once constructed, so references returned by Entity::Add<>() stay valid.
+		//- Released slots are recycled before new ones are claimed, keeping the chunks densely populated.
+		class ComponentStorage
+		{
+		public:
+			//- The size, in bytes, targeted for each chunk.
+			static constexpr u32 ChunkBytes = 16 * 1024;
+
+			ComponentStorage(u32 componentId, u32 size, u32 alignment, s32 baseOffset);
+			ComponentStorage(const ComponentStorage&) = delete;
+			ComponentStorage& operator=(const ComponentStorage&) = delete;
+
+			//- Claims a slot large enough to construct a new instance in.
+			u32 Allocate();
+			//- Returns a slot to the storage. The instance must have already been destroyed.
+			void Release(u32 slot);
+
+			//- Returns the raw memory of the slot, suitable for placement-new.
+			void* GetAddress(u32 slot) const
+			{
+				return chunks[slot / chunkCapacity].data + (slot % chunkCapacity) * stride;
+			}
+
+			//- Marks whether or not the instance in the slot is visible to queries.
+			void SetActive(u32 slot, bool state)
+			{
+				chunks[slot / chunkCapacity].active[slot % chunkCapacity] = state ? 1 : 0;
+			}
+
+			//- The ID shared by all types stored under the same Component<> base.
+			u32 GetComponentId() const { return componentId; }
+			//- The number of chunks currently allocated.
+			u32 GetNumChunks() const { return chunks.size(); }
+			//- The maximum number of instances held by a single chunk.
+			u32 GetChunkCapacity() const { return chunkCapacity; }
+			//- The number of live instances.
+			u32 GetCount() const { return count; }
+			//- The number of instances allocated over the lifetime of the storage.
+			u64 GetTotalAllocations() const { return totalAllocations; }
+
+			//- The number of slots of the chunk that have ever been claimed. Slots beyond this have never been touched.
+			u32 GetChunkSize(u32 chunk) const { return chunks[chunk].size; }
+
+			//- Returns true if the instance in the chunk is visible to queries.
+			bool IsActive(u32 chunk, u32 index) const { return chunks[chunk].active[index] != 0; }
+
+			//- Returns the instance at the given position of a chunk.
+			ComponentBase* GetComponent(u32 chunk, u32 index) const
+			{
+				return reinterpret_cast<ComponentBase*>(chunks[chunk].data + index * stride + baseOffset);
+			}
+
+		private:
+			struct Chunk
+			{
+				//- Backing memory of the chunk, aligned for the stored type.
+				u8* data = nullptr;
+				//- Query visibility of each slot.
+				u8* active = nullptr;
+				//- The number of slots claimed so far. Grows monotonically.
+				u32 size = 0;
+
+				std::unique_ptr<u8[]> memory;
+			};
+
+			const u32 componentId;
+			//- Distance between consecutive instances.
+			const u32 stride;
+			//- Offset from the start of the stored type to its ComponentBase.
+			const s32 baseOffset;
+			const u32 alignment;
+			const u32 chunkCapacity;
+
+			u32 count = 0;
+			u64 totalAllocations = 0;
+			std::vector<Chunk> chunks;
+			std::vector<u32> freeSlots;
+		};
+
+		//- Consumes a new storage type index. Used statically by GetStorageTypeIndex<>().
+		u32 NextStorageTypeIndex();
+
+		//- Returns a small index unique to the concrete type T, used to look up its storage in each World.
+		template<class T>
+		u32 GetStorageTypeIndex()
+		{
+			static const u32 typeIndex = NextStorageTypeIndex();
+			return typeIndex;
+		}
+
+		//- Returns the distance between a T and its ComponentBase, which is only non-zero under multiple inheritance.
+		template<class T>
+		s32 GetBaseOffset()
+		{
+			return static_cast<s32>(
+				reinterpret_cast<const char*>(static_cast<const ComponentBase*>(reinterpret_cast<const T*>(alignof(T) * 16))) -
+				reinterpret_cast<const char*>(alignof(T) * 16));
+		}
+	}
+}
@@ -6,18 +6,30 @@
 #include "Jewel3D/Rendering/Material.h"
 
 #include <algorithm>
+#include <atomic>
 
 namespace Jwl
 {
 	namespace detail
 	{
-		std::unordered_map<u32, std::vector<Entity*>> entityIndex;
-		std::unordered_map<u32, std::vector<ComponentBase*>> componentIndex;
+		//- The last change version given out. Shared by Components and world transforms.
+		static std::atomic<u64> latestChangeVersion(0);
+
+		u64 NextChangeVersion()
+		{
+			return ++latestChangeVersion;
+		}
+	}
+
+	u64 GetLatestChangeVersion()
+	{
+		return detail::latestChangeVersion;
 	}
 
 	ComponentBase::ComponentBase(Entity& _owner, u32 _componentId)
 		: owner(_owner)
 		, componentId(_componentId)
+		, changeVersion(detail::NextChangeVersion())
 	{
 	}
 
@@ -38,6 +50,21 @@ namespace Jwl
 		return isEnabled;
 	}
 
+	void ComponentBase::MarkChanged()
+	{
+		changeVersion = detail::NextChangeVersion();
+	}
+
+	u64 ComponentBase::GetChangeVersion() const
+	{
+		return changeVersion;
+	}
+
+	bool ComponentBase::HasChangedSince(u64 version) const
+	{
+		return changeVersion > version;
+	}
+
 	u32 ComponentBase::GenerateID()
 	{
 		static u32 counter = 1;
@@ -50,7 +77,13 @@ namespace Jwl
 	}
 
 	Entity::Entity(const Transform& pose)
-		: Transform(pose)
+		: localTransform(pose)
+	{
+		MarkMoved();
+	}
+
+	Entity::Entity(World& _world)
+		: world(_world)
 	{
 	}
 
@@ -58,13 +91,15 @@ namespace Jwl
 	{
 		RemoveAllComponents();
 		RemoveAllTags();
+
+		world.ReleaseId(id);
 	}
 
 	Entity::Ptr Entity::Duplicate() const
 	{
-		auto newEntity = MakeNew();
+		auto newEntity = world.CreateEntity();
 
-		newEntity->Transform::operator=(*this);
+		newEntity->SetLocalTransform(localTransform);
 		newEntity->Hierarchy<Entity>::operator=(*this);
 
 		/* Copy all tags */
@@ -116,25 +151,28 @@ namespace Jwl
 			{
 				auto comp = components[i];
 				components.erase(components.begin() + i);
+				lookup.Remove(comp->componentId);
 
 				if (comp->IsEnabled())
 				{
 					Unindex(*comp);
 				}
 
-				delete comp;
+				DestroyComponent(comp);
 			}
 		}
 	}
 
 	void Entity::RemoveAllTags()
 	{
-		if (IsEnabled())
+		for (auto tag : tags)
 		{
-			for (auto tag : tags)
+			if (IsEnabled())
 			{
 				UnindexTag(tag);
 			}
+
+			lookup.Remove(tag);
 		}
 
 		tags.clear();
@@ -192,14 +230,157 @@ namespace Jwl
 		isEnabled = false;
 	}
 
+	void Entity::EnableSubtree()
+	{
+		SetSubtreeEnabled(true);
+	}
+
+	void Entity::DisableSubtree()
+	{
+		SetSubtreeEnabled(false);
+	}
+
+	void Entity::SetSubtreeEnabled(bool enabled)
+	{
+		// Gather the Entities of the subtree that need to change.
+		std::vector<Entity*> changed;
+		for (Entity& ent : GetSubtree())
+		{
+			ASSERT(&ent.world == &world, "The subtree of an Entity must belong to a single World.");
+
+			if (ent.isEnabled != enabled)
+			{
+				changed.push_back(&ent);
+			}
+		}
+
+		if (changed.empty())
+		{
+			return;
+		}
+
+		IndexBatch(changed, enabled);
+
+		for (Entity* ent : changed)
+		{
+			ent->isEnabled = enabled;
+		}
+
+		// Finally, notify the Components once the whole subtree is in its new state.
+		for (Entity* ent : changed)
+		{
+			for (auto comp : ent->components)
+			{
+				if (comp->IsComponentEnabled())
+				{
+					if (enabled)
+					{
+						comp->OnEnable();
+					}
+					else
+					{
+						comp->OnDisable();
+					}
+				}
+			}
+		}
+	}
+
+	void Entity::IndexBatch(const std::vector<Entity*>& entities, bool indexed)
+	{
+		ASSERT(!entities.empty(), "IndexBatch() requires at least one Entity.");
+		auto& entityIndex = entities.front()->world.entityIndex;
+		auto& queryIndex = entities.front()->world.queryIndex;
+
+		// Group the changes by table.
+		std::unordered_map<u32, std::vector<Entity*>> tableChanges;
+		for (Entity* ent : entities)
+		{
+			for (auto comp : ent->components)
+			{
+				if (comp->IsComponentEnabled())
+				{
+					tableChanges[comp->componentId].push_back(ent);
+					comp->storage->SetActive(comp->storageSlot, indexed);
+				}
+			}
+
+			for (u32 tag : ent->tags)
+			{
+				tableChanges[tag].push_back(ent);
+			}
+		}
+
+		// Update each table of the index in a single pass.
+		for (auto& pair : tableChanges)
+		{
+			auto& table = entityIndex[pair.first];
+			if (indexed)
+			{
+				table.Reserve(table.Size() + pair.second.size());
+				for (Entity* ent : pair.second)
+				{
+					table.Insert(ent->id, ent);
+				}
+			}
+			else
+			{
+				for (Entity* ent : pair.second)
+				{
+					table.Remove(ent->id);
+				}
+			}
+		}
+
+		// Cached queries are updated once all the tables are complete, so that each match is only tested against the final state.
+		for (auto& pair : tableChanges)
+		{
+			auto itr = queryIndex.find(pair.first);
+			if (itr == queryIndex.end())
+			{
+				continue;
+			}
+
+			for (auto query : itr->second)
+			{
+				for (Entity* ent : pair.second)
+				{
+					if (indexed)
+					{
+						query->OnIndexed(*ent);
+					}
+					else
+					{
+						query->OnUnindexed(*ent);
+					}
+				}
+			}
+		}
+	}
+
 	bool Entity::IsEnabled() const
 	{
 		return isEnabled;
 	}
 
+	u32 Entity::GetId() const
+	{
+		return id;
+	}
+
+	EntityHandle Entity::GetHandle() const
+	{
+		return EntityHandle(id, world.entitySlots[id].generation, world.index);
+	}
+
+	World& Entity::GetWorld() const
+	{
+		return world;
+	}
+
 	Entity::Ptr Entity::CreateChild()
 	{
-		auto child = Entity::MakeNew();
+		auto child = world.CreateEntity();
 		AddChild(child);
 
 		return child;
@@ -213,30 +394,55 @@ namespace Jwl
 		}
 
 		tags.push_back(tagId);
+		lookup.Insert(tagId, nullptr);
 	}
 
 	void Entity::RemoveTag(u32 tagId)
 	{
+		if (!lookup.Contains(tagId))
+		{
+			return;
+		}
+
 		if (IsEnabled())
 		{
 			UnindexTag(tagId);
 		}
 
 		tags.erase(std::find(tags.begin(), tags.end(), tagId));
+		lookup.Remove(tagId);
 	}
 
 	void Entity::IndexTag(u32 tagId)
 	{
 		// Adjust [id, entity] index.
-		auto& table = detail::entityIndex[tagId];
-		table.insert(std::lower_bound(table.begin(), table.end(), this), this);
+		world.entityIndex[tagId].Insert(id, this);
+
+		// Update any cached queries depending on the table.
+		auto itr = world.queryIndex.find(tagId);
+		if (itr != world.queryIndex.end())
+		{
+			for (auto query : itr->second)
+			{
+				query->OnIndexed(*this);
+			}
+		}
 	}
 
 	void Entity::UnindexTag(u32 tagId)
 	{
 		// Adjust [id, entity] index.
-		auto& table = detail::entityIndex[tagId];
-		table.erase(std::lower_bound(table.begin(), table.end(), this));
+		world.entityIndex[tagId].Remove(id);
+
+		// Update any cached queries depending on the table.
+		auto itr = world.queryIndex.find(tagId);
+		if (itr != world.queryIndex.end())
+		{
+			for (auto query : itr->second)
+			{
+				query->OnUnindexed(*this);
+			}
+		}
 	}
 
 	void Entity::Index(ComponentBase& comp)
@@ -244,8 +450,8 @@ namespace Jwl
 		// Adjust [id, entity] index.
 		IndexTag(comp.componentId);
 
-		// Adjust [id, component] index.
-		detail::componentIndex[comp.componentId].push_back(&comp);
+		// Expose the component to All<>() queries.
+		comp.storage->SetActive(comp.storageSlot, true);
 	}
 
 	void Entity::Unindex(ComponentBase& comp)
@@ -253,30 +459,203 @@ namespace Jwl
 		// Adjust [id, entity] index.
 		UnindexTag(comp.componentId);
 
-		// Adjust [id, component] index.
-		auto& componentTable = detail::componentIndex[comp.componentId];
-		componentTable.erase(std::find(componentTable.begin(), componentTable.end(), &comp));
+		// Hide the component from All<>() queries.
+		comp.storage->SetActive(comp.storageSlot, false);
 	}
 
-	mat4 Entity::GetWorldTransform() const
+	void Entity::DestroyComponent(ComponentBase* comp)
 	{
-		mat4 transform(rotation, position);
-		reinterpret_cast<vec3*>(&transform.data[mat4::RightX])->operator*=(scale.x);
-		reinterpret_cast<vec3*>(&transform.data[mat4::UpX])->operator*=(scale.y);
-		reinterpret_cast<vec3*>(&transform.data[mat4::ForwardX])->operator*=(scale.z);
+		auto storage = comp->storage;
+		u32 slot = comp->storageSlot;
 
-		if (auto parentEntity = GetParent())
+		comp->~ComponentBase();
+		storage->Release(slot);
+	}
+
+	const Transform& Entity::GetLocalTransform() const
+	{
+		return localTransform;
+	}
+
+	const vec3& Entity::GetPosition() const
+	{
+		return localTransform.position;
+	}
+
+	const quat& Entity::GetRotation() const
+	{
+		return localTransform.rotation;
+	}
+
+	const vec3& Entity::GetScale() const
+	{
+		return localTransform.scale;
+	}
+
+	void Entity::SetLocalTransform(const Transform& transform)
+	{
+		localTransform = transform;
+		MarkMoved();
+	}
+
+	void Entity::SetPosition(const vec3& _position)
+	{
+		localTransform.position = _position;
+		MarkMoved();
+	}
+
+	void Entity::SetRotation(const quat& _rotation)
+	{
+		localTransform.rotation = _rotation;
+		MarkMoved();
+	}
+
+	void Entity::SetScale(const vec3& _scale)
+	{
+		localTransform.scale = _scale;
+		MarkMoved();
+	}
+
+	void Entity::Rotate(const vec3& axis, f32 degrees)
+	{
+		localTransform.Rotate(axis, degrees);
+		MarkMoved();
+	}
+
+	void Entity::RotateX(f32 degrees)
+	{
+		localTransform.RotateX(degrees);
+		MarkMoved();
+	}
+
+	void Entity::RotateY(f32 degrees)
+	{
+		localTransform.RotateY(degrees);
+		MarkMoved();
+	}
+
+	void Entity::RotateZ(f32 degrees)
+	{
+		localTransform.RotateZ(degrees);
+		MarkMoved();
+	}
+
+	const mat4& Entity::GetWorldTransform() const
+	{
+		if (!isWorldTransformDirty)
 		{
-			transform = parentEntity->GetWorldTransform() * transform;
+			return worldTransform;
 		}
 
-		return transform;
+		// The out of date ancestors are all adjacent to this Entity, since the descendants of an out of date Entity
+		// are always out of date as well. They are refreshed from the top down, without recursion.
+		thread_local std::vector<const Entity*> ancestors;
+		ancestors.clear();
+
+		for (const Entity* ancestor = GetParentNode(); ancestor && ancestor->isWorldTransformDirty; ancestor = ancestor->GetParentNode())
+		{
+			ancestors.push_back(ancestor);
+		}
+
+		// The rest of their descendants are still out of date, so they are flagged for UpdateSubtreeTransforms() to find.
+		for (auto itr = ancestors.rbegin(); itr != ancestors.rend(); ++itr)
+		{
+			(*itr)->UpdateWorldTransform((*itr)->GetParentNode());
+			(*itr)->hasDirtyDescendants = true;
+		}
+
+		UpdateWorldTransform(GetParentNode());
+		hasDirtyDescendants = true;
+
+		return worldTransform;
+	}
+
+	void Entity::UpdateWorldTransforms()
+	{
+		World::GetDefault().UpdateWorldTransforms();
+	}
+
+	void Entity::MarkMoved()
+	{
+		if (isWorldTransformDirty)
+		{
+			return;
+		}
+
+		// The traversal stops at the descendants which are already out of date, since their own descendants are as well.
+		VisitSubtree([](Entity& node) {
+			if (node.isWorldTransformDirty)
+			{
+				return false;
+			}
+
+			node.isWorldTransformDirty = true;
+			return true;
+		});
+
+		world.QueueMoved(id);
+	}
+
+	void Entity::OnParentChanged()
+	{
+		MarkMoved();
+
+		// Even if it was already out of date, the Entity might have been moved away from the one which was queued.
+		world.QueueMoved(id);
+	}
+
+	void Entity::UpdateWorldTransform(const Entity* parent) const
+	{
+		const vec3& scale = localTransform.scale;
+
+		worldTransform = mat4(localTransform.rotation, localTransform.position);
+		reinterpret_cast<vec3*>(&worldTransform.data[mat4::RightX])->operator*=(scale.x);
+		reinterpret_cast<vec3*>(&worldTransform.data[mat4::UpX])->operator*=(scale.y);
+		reinterpret_cast<vec3*>(&worldTransform.data[mat4::ForwardX])->operator*=(scale.z);
+
+		if (parent)
+		{
+			worldTransform = parent->worldTransform * worldTransform;
+		}
+
+		worldTransformVersion = detail::NextChangeVersion();
+		isWorldTransformDirty = false;
+	}
+
+	void Entity::UpdateSubtreeTransforms()
+	{
+		// Refreshes any out of date ancestors as well.
+		GetWorldTransform();
+
+		// Parents are visited before their children. The traversal only descends through Entities which were out of date,
+		// or which were refreshed early by GetWorldTransform(). Below any other Entity, the subtree is already up to date.
+		VisitSubtree([](Entity& node) {
+			if (node.isWorldTransformDirty)
+			{
+				node.UpdateWorldTransform(node.GetParentNode());
+				node.hasDirtyDescendants = false;
+				return true;
+			}
+
+			if (node.hasDirtyDescendants)
+			{
+				node.hasDirtyDescendants = false;
+				return true;
+			}
+
+			return false;
+		});
+	}
+
+	u64 Entity::GetWorldTransformVersion() const
+	{
+		return worldTransformVersion;
 	}
 
 	void Entity::LookAt(const vec3& pos, const vec3& target, const vec3& up)
 	{
-		// Passthrough to get around C++ name-hiding.
-		Transform::LookAt(pos, target, up);
+		localTransform.LookAt(pos, target, up);
+		MarkMoved();
 	}
 
 	void Entity::LookAt(const Entity& target, const vec3& up)
@@ -293,6 +672,6 @@ namespace Jwl
 			targetPos = (parentEntity->GetWorldTransform() * vec4(targetPos, 1.0f)).ToVec3();
 		}
 
-		LookAt(position, targetPos, up);
+		LookAt(localTransform.position, targetPos, up);
 	}
 }
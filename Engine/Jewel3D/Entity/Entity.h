@@ -1,11 +1,19 @@
 // Copyright (c) 2017 Emilian Cioca
 #pragma once
 #include "Jewel3D/Application/Logging.h"
+#include "Jewel3D/Application/WorkerPool.h"
+#include "Jewel3D/Entity/ComponentMap.h"
+#include "Jewel3D/Entity/ComponentStorage.h"
+#include "Jewel3D/Entity/EntityHandle.h"
+#include "Jewel3D/Entity/World.h"
 #include "Jewel3D/Math/Matrix.h"
 #include "Jewel3D/Math/Transform.h"
 #include "Jewel3D/Utilities/Hierarchy.h"
 #include "Jewel3D/Utilities/Meta.h"
+#include "Jewel3D/Utilities/SparseSet.h"
 
+#include <algorithm>
+#include <array>
 #include <iterator>
 #include <string>
 #include <type_traits>
@@ -16,9 +24,20 @@ namespace Jwl
 {
 	class Entity;
 
+	namespace detail
+	{
+		template<u32 NumTables> struct ChangeFilter;
+		struct SceneSerializer;
+
+		//- Returns a new change version, greater than all previous ones.
+		u64 NextChangeVersion();
+	}
+
 	class ComponentBase
 	{
 		friend Entity;
+		friend class Prefab;
+		friend detail::SceneSerializer;
 	public:
 		ComponentBase() = delete;
 		ComponentBase(const ComponentBase&) = delete;
@@ -32,6 +51,14 @@ namespace Jwl
 		//- Returns true if the component itself is enabled, regardless of the owner's state.
 		bool IsComponentEnabled() const;
 
+		//- Flags the component as changed, so that it is matched by queries using Changed<>.
+		//- Components are flagged automatically when they are added. This is safe to call from parallel queries.
+		void MarkChanged();
+		//- Returns the change version at which the component was last flagged as changed.
+		u64 GetChangeVersion() const;
+		//- Returns true if the component was flagged as changed after the specified change version.
+		bool HasChangedSince(u64 version) const;
+
 		//- The Entity to which this component is attached.
 		Entity& owner;
 		//- The unique ID used by the derived component.
@@ -50,8 +77,17 @@ namespace Jwl
 		virtual void Copy(Entity& newOwner) const = 0;
 
 		bool isEnabled = true;
+		u64 changeVersion;
+
+		//- The storage holding this instance, and its position within it.
+		detail::ComponentStorage* storage = nullptr;
+		u32 storageSlot = 0;
 	};
 
+	//- Returns the most recent change version. Versions increase every time something is flagged as changed.
+	//- Store the result in order to later query for the changes made after this point.
+	u64 GetLatestChangeVersion();
+
 	//- For serialization, all components must be constructible with just an Entity reference.
 	//- Derive from this to create a new component. Your class should pass itself as the template:
 	//	class NewComponent : public Component<NewComponent> { /* */ };
@@ -82,14 +118,19 @@ namespace Jwl
 
 	//- An Entity is a container for Components.
 	//- This is the primary object representing an element of a scene.
-	//- All Entities must be created through Entity::MakeNew().
-	class Entity : public Hierarchy<Entity>, public Transform
+	//- All Entities must be created through Entity::MakeNew(), or World::CreateEntity().
+	class Entity : public Hierarchy<Entity>
 	{
-		friend ShareableAlloc;
+		friend Hierarchy<Entity>;
+		friend World;
+		friend class Prefab;
+		friend detail::SceneSerializer;
+		template<u32> friend struct detail::ChangeFilter;
 
 		Entity() = default;
 		Entity(const std::string& name);
 		Entity(const Transform& pose);
+		Entity(World& world);
 
 		Entity(const Entity&) = delete;
 		Entity& operator=(const Entity&) = delete;
@@ -97,6 +138,10 @@ namespace Jwl
 	public:
 		~Entity();
 
+		//- Creates a new Entity in the default World, using its pools. Use World::CreateEntity() for other Worlds.
+		template<typename... Args>
+		static Ptr MakeNew(Args&&... params);
+
 		//- Returns a pointer to the new Component.
 		template<class T, typename... Args>
 		T& Add(Args&&... constructorParams);
@@ -153,6 +198,14 @@ namespace Jwl
 		//- Disabling this Entity is equivalent to individually disabling all its components.
 		void Disable();
 
+		//- Enables this Entity along with all of its descendants.
+		//- The changes to the index are batched together, one table at a time, which is much faster
+		//  than enabling each Entity individually. OnEnable() is then called on every Component in a single pass.
+		void EnableSubtree();
+
+		//- Disables this Entity along with all of its descendants, batching the changes like EnableSubtree().
+		void DisableSubtree();
+
 		//- Enables the specific component. It will be made visible to queries if this entity is also enabled.
 		template<class T>
 		void Enable();
@@ -164,18 +217,70 @@ namespace Jwl
 		//- Whether or not this Entity is visible to queries.
 		bool IsEnabled() const;
 
-		//- Creates and returns a new child entity.
+		//- Returns an ID unique among all living Entities of the same World.
+		//- IDs are recycled once their Entity is destroyed.
+		u32 GetId() const;
+
+		//- Returns the World that the Entity belongs to.
+		World& GetWorld() const;
+
+		//- Returns a lightweight, non-owning reference to this Entity.
+		//- Unlike the ID, the handle is never reused by another Entity.
+		EntityHandle GetHandle() const;
+
+		//- Returns this Entity and its descendants which have an active instance of each specified Component/Tag.
+		//- This matches the free function With<>(), but only visits this subtree. The cost is proportional to the
+		//  size of the subtree rather than the World, such as when querying a single vehicle, UI window, or level chunk.
+		//! Like With<>(), changing the queried types, or the hierarchy, will invalidate the returned Range.
+		template<typename... Args>
+		auto With(u64 since = 0);
+
+		//- Creates and returns a new child entity, in the same World.
 		Entity::Ptr CreateChild();
 
-		//- Creates and returns a new Entity that is a copy of this one.
+		//- Creates and returns a new Entity that is a copy of this one, in the same World.
 		Entity::Ptr Duplicate() const;
 
 		//- Copies the component onto this Entity.
 		//- It is added if an instance does not already exist on this Entity.
 		void CopyComponent(const ComponentBase& source);
 
+		//- The pose of the Entity, relative to its parent.
+		//- Each change marks the world transforms of the Entity and its descendants as out of date. Marking is not atomic,
+		//  so Entities may only be moved from parallel queries if no other thread moves an Entity of the same branch of the
+		//  hierarchy, or reads the world transform of one of the descendants, at the same time.
+		const Transform& GetLocalTransform() const;
+		const vec3& GetPosition() const;
+		const quat& GetRotation() const;
+		const vec3& GetScale() const;
+
+		void SetLocalTransform(const Transform& transform);
+		void SetPosition(const vec3& _position);
+		void SetRotation(const quat& _rotation);
+		void SetScale(const vec3& _scale);
+
+		//- These match the functions of Transform.
+		void Rotate(const vec3& axis, f32 degrees);
+		void RotateX(f32 degrees);
+		void RotateY(f32 degrees);
+		void RotateZ(f32 degrees);
+
 		//- Returns the true transformation of the Entity, accumulated from the root of the hierarchy.
-		mat4 GetWorldTransform() const;
+		//- The result is cached, so this is a constant-time read unless the Entity or one of its ancestors has moved.
+		//  In that case, only the out of date ancestors are recomputed.
+		//! Recomputing writes to the caches of the ancestors. From parallel queries, this is only safe to call if no
+		//  thread might move the Entity or one of its ancestors during the same query.
+		const mat4& GetWorldTransform() const;
+
+		//- Refreshes the cached world transform of every Entity that moved in the default World, along with their descendants.
+		//- This is done once per update by the Application. Afterwards, GetWorldTransform() only reads
+		//  from the cache until the Entity or one of its ancestors moves.
+		static void UpdateWorldTransforms();
+
+		//- Returns the change version at which the world transform last changed.
+		//- This is comparable with the change versions of Components. It is only current
+		//  after a call to GetWorldTransform() or UpdateWorldTransforms().
+		u64 GetWorldTransformVersion() const;
 
 		//- Positions the Entity at 'pos' looking towards the 'target' in local space.
 		void LookAt(const vec3& pos, const vec3& target, const vec3& up = vec3::Up);
@@ -193,10 +298,53 @@ namespace Jwl
 		void Index(ComponentBase& comp);
 		void Unindex(ComponentBase& comp);
 
+		//- Implements EnableSubtree() and DisableSubtree().
+		void SetSubtreeEnabled(bool enabled);
+
+		//- Adds or removes the enabled Components and Tags of many Entities to/from the index at once, one table at a time.
+		//- The Entities must all belong to the same World. Their own enabled state is left for the caller to update.
+		static void IndexBatch(const std::vector<Entity*>& entities, bool indexed);
+
+		//- Marks the world transforms of this Entity and its descendants as out of date.
+		void MarkMoved();
+
+		//- Called by the Hierarchy when the Entity is attached to, or detached from, a parent.
+		void OnParentChanged();
+
+		//- Recomputes the cached world transform. The parent's cache must already be up to date.
+		void UpdateWorldTransform(const Entity* parent) const;
+
+		//- Brings the cached world transforms of this Entity and its descendants up to date.
+		//- Only the out of date parts of the subtree are visited, so this returns immediately if it is already up to date.
+		void UpdateSubtreeTransforms();
+
+		//- Destroys the component and returns its memory to the storage.
+		static void DestroyComponent(ComponentBase* comp);
+
+		World& world = World::GetDefault();
+		//- Keys this Entity in the sparse tables of the index, and in the entitySlots table.
+		const u32 id = world.AcquireId(*this);
+
+		//- Components and Tags in the order they were added.
 		std::vector<ComponentBase*> components;
 		std::vector<u32> tags;
+		//- Constant-time lookup of both Components and Tags by their ID.
+		detail::ComponentMap lookup;
 
 		bool isEnabled = true;
+
+		//- The pose of the Entity, relative to its parent. Only modified through the setters, which track movement.
+		Transform localTransform;
+
+		//- The cached world transform, and the change version at which it was computed.
+		mutable mat4 worldTransform;
+		mutable u64 worldTransformVersion = detail::NextChangeVersion();
+		//- Set while worldTransform is out of date. The descendants of an out of date Entity are always out of date as well,
+		//  so marking a subtree stops at the Entities which are already marked.
+		mutable bool isWorldTransformDirty = false;
+		//- Set when GetWorldTransform() refreshes the Entity ahead of UpdateWorldTransforms(), which leaves its descendants
+		//  out of date below an up to date Entity. This lets UpdateSubtreeTransforms() skip the subtrees that are clean.
+		mutable bool hasDirtyDescendants = false;
 	};
 }
 
@@ -75,6 +75,21 @@ namespace Jwl
 		detail::copy_component(newOwner, *static_cast<const derived*>(this));
 	}
 
+	template<typename... Args>
+	Entity::Ptr Entity::MakeNew(Args&&... params)
+	{
+		return World::GetDefault().NewEntity(std::forward<Args>(params)...);
+	}
+
+	template<typename... Args>
+	Entity::Ptr World::NewEntity(Args&&... params)
+	{
+		Entity* ent = new (entityPool.Allocate()) Entity(std::forward<Args>(params)...);
+
+		// The control block is pooled as well, so that no part of the Entity touches the heap.
+		return Entity::Ptr(ent, detail::EntityDeleter{ &entityPool }, detail::PoolAllocator<Entity>(*controlBlockPool));
+	}
+
 	template<class T, typename... Args>
 	T& Entity::Add(Args&&... constructorParams)
 	{
@@ -82,8 +97,14 @@ namespace Jwl
 		static_assert(!std::is_base_of<TagBase, T>::value, "Template argument cannot be a Tag");
 		ASSERT(!Has<T>(), "Component already exists on this entity.");
 
-		T* newComponent = new T(*this, std::forward<Args>(constructorParams)...);
+		auto& storage = world.GetStorage<T>();
+		u32 slot = storage.Allocate();
+
+		T* newComponent = new (storage.GetAddress(slot)) T(*this, std::forward<Args>(constructorParams)...);
+		newComponent->storage = &storage;
+		newComponent->storageSlot = slot;
 		components.push_back(newComponent);
+		lookup.Insert(T::GetComponentId(), newComponent);
 
 		if (IsEnabled())
 		{
@@ -136,18 +157,10 @@ namespace Jwl
 		static_assert(std::is_base_of<ComponentBase, T>::value, "Template argument must inherit from Component.");
 		static_assert(!std::is_base_of<TagBase, T>::value, "Template argument cannot be a Tag");
 
-		auto itr = components.begin();
-		for (; itr != components.end(); itr++)
-		{
-			if ((*itr)->componentId == T::GetComponentId())
-			{
-				ASSERT(safe_cast<T>(*itr), "Entity did not have the expected component.");
-				break;
-			}
-		}
+		ComponentBase* comp = lookup.Get(T::GetComponentId());
+		ASSERT(comp && safe_cast<T>(comp), "Entity did not have the expected component.");
 
-		ASSERT(itr != components.end(), "Entity did not have the expected component.");
-		return *static_cast<T*>(*itr);
+		return *static_cast<T*>(comp);
 	}
 
 	template<class T>
@@ -157,12 +170,9 @@ namespace Jwl
 		static_assert(std::is_base_of<ComponentBase, T>::value, "Template argument must inherit from Component.");
 		static_assert(!std::is_base_of<TagBase, T>::value, "Template argument cannot be a Tag");
 
-		for (auto comp : components)
+		if (ComponentBase* comp = lookup.Get(T::GetComponentId()))
 		{
-			if (comp->componentId == T::GetComponentId())
-			{
-				return safe_cast<T>(comp);
-			}
+			return safe_cast<T>(comp);
 		}
 
 		return nullptr;
@@ -175,26 +185,21 @@ namespace Jwl
 		static_assert(std::is_base_of<ComponentBase, T>::value, "Template argument must inherit from Component.");
 		static_assert(!std::is_base_of<TagBase, T>::value, "Template argument cannot be a Tag");
 
-		for (unsigned i = 0; i < components.size(); i++)
+		ComponentBase* comp = lookup.Get(T::GetComponentId());
+		if (!comp || !safe_cast<T>(comp))
 		{
-			if (components[i]->componentId == T::GetComponentId())
-			{
-				if (safe_cast<T>(components[i]))
-				{
-					auto comp = components[i];
-					components.erase(components.begin() + i);
-
-					if (comp->IsEnabled())
-					{
-						Unindex(*comp);
-					}
+			return;
+		}
 
-					delete comp;
-				}
+		components.erase(std::find(components.begin(), components.end(), comp));
+		lookup.Remove(comp->componentId);
 
-				return;
-			}
+		if (comp->IsEnabled())
+		{
+			Unindex(*comp);
 		}
+
+		DestroyComponent(comp);
 	}
 
 	template<class T>
@@ -231,15 +236,7 @@ namespace Jwl
 	{
 		static_assert(std::is_base_of<TagBase, T>::value, "Template argument must inherit from Tag.");
 
-		for (auto tag : tags)
-		{
-			if (tag == T::GetComponentId())
-			{
-				return true;
-			}
-		}
-
-		return false;
+		return lookup.Contains(T::GetComponentId());
 	}
 
 	template<class T>
@@ -0,0 +1,115 @@
+// Copyright (c) 2017 Emilian Cioca
+#include "Jewel3D/Precompiled.h"
+#include "EntityCommandBuffer.h"
+#include "Jewel3D/Application/Threading.h"
+
+#include <algorithm>
+
+namespace Jwl
+{
+	EntityCommandBuffer::EntityCommandBuffer()
+		: lock(std::make_unique<Mutex>())
+	{
+		bool result = lock->Init();
+		ASSERT(result, "EntityCommandBuffer: Failed to create mutex.");
+	}
+
+	EntityCommandBuffer::~EntityCommandBuffer()
+	{
+		if (!commands.empty())
+		{
+			Warning("EntityCommandBuffer: Destroyed with %u commands that were never played back.", commands.size());
+		}
+	}
+
+	void EntityCommandBuffer::Enable(Entity& ent)
+	{
+		Record(ent, Phase::Entities, 0, [](Entity& e) {
+			e.Enable();
+		});
+	}
+
+	void EntityCommandBuffer::Disable(Entity& ent)
+	{
+		Record(ent, Phase::Entities, 0, [](Entity& e) {
+			e.Disable();
+		});
+	}
+
+	void EntityCommandBuffer::Destroy(Entity& ent)
+	{
+		Record(ent, Phase::Destroy, 0, [](Entity& e) {
+			e.RemoveAllComponents();
+			e.RemoveAllTags();
+
+			// This must come last, since it might release the final reference to the Entity.
+			if (auto parent = e.GetParent())
+			{
+				parent->RemoveChild(e);
+			}
+		});
+	}
+
+	void EntityCommandBuffer::Playback()
+	{
+		// Commands recorded while playing back, such as from OnEnable(), are deferred to the next playback.
+		std::vector<Command> batch;
+		lock->Lock();
+		batch.swap(commands);
+		lock->Unlock();
+
+		// Group the commands so that each table is touched in one pass. The sort is stable,
+		// so commands on the same Entity and type keep the order in which they were recorded.
+		std::stable_sort(batch.begin(), batch.end(), [](const Command& a, const Command& b) {
+			if (a.phase != b.phase)
+			{
+				return a.phase < b.phase;
+			}
+
+			if (a.id != b.id)
+			{
+				return a.id < b.id;
+			}
+
+			return a.entity.GetIndex() < b.entity.GetIndex();
+		});
+
+		for (auto& command : batch)
+		{
+			if (Entity* ent = command.entity.Get())
+			{
+				command.apply(*ent);
+			}
+		}
+	}
+
+	void EntityCommandBuffer::Clear()
+	{
+		lock->Lock();
+		commands.clear();
+		lock->Unlock();
+	}
+
+	u32 EntityCommandBuffer::GetNumCommands() const
+	{
+		lock->Lock();
+		u32 result = commands.size();
+		lock->Unlock();
+
+		return result;
+	}
+
+	bool EntityCommandBuffer::IsEmpty() const
+	{
+		return GetNumCommands() == 0;
+	}
+
+	void EntityCommandBuffer::Record(Entity& ent, Phase phase, u32 id, Action apply)
+	{
+		Command command = { ent.GetHandle(), phase, id, std::move(apply) };
+
+		lock->Lock();
+		commands.push_back(std::move(command));
+		lock->Unlock();
+	}
+}
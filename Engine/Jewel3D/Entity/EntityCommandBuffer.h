@@ -0,0 +1,153 @@
+// Copyright (c) 2017 Emilian Cioca
+#pragma once
+#include "Entity.h"
+#include "Jewel3D/Utilities/InlineFunction.h"
+
+#include <memory>
+#include <vector>
+
+namespace Jwl
+{
+	class Mutex;
+
+	//- Records structural changes to Entities so that they can be applied later, all at once.
+	//- This allows Components and Tags to be added or removed while iterating a query, without having
+	//  to capture the results first with CaptureWith<>(). It also works from inside of parallel queries.
+	//- Recording is thread-safe. Playback() must be called from one thread, outside of any iteration.
+	//- Playback applies the commands grouped by Component/Tag type, so that each table of the index is
+	//  updated in a single pass. Commands are applied in three phases:
+	//	1. Adding, removing, enabling, and disabling Components, and adding and removing Tags.
+	//	2. Enabling and disabling whole Entities.
+	//	3. Destroying Entities.
+	//	Commands affecting the same Entity and type are always applied in the order they were recorded.
+	//- Entities are recorded by EntityHandle, so recording does no reference counting. Commands for
+	//  Entities which no longer exist at playback are skipped.
+	class EntityCommandBuffer
+	{
+	public:
+		EntityCommandBuffer();
+		EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+		EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+		~EntityCommandBuffer();
+
+		//- Records the addition of a Component. The constructor parameters are copied until playback.
+		//- If the Entity already has the Component at playback time, the command is ignored.
+		//- Parameters totaling up to four pointers in size are stored inside of the command. Larger
+		//  parameters are copied to the heap, so prefer passing handles over large values.
+		//- Like every command, this takes a short lock on the buffer while recording.
+		template<class T, typename... Args>
+		void Add(Entity& ent, const Args&... constructorParams)
+		{
+			static_assert(std::is_base_of<ComponentBase, T>::value, "Template argument must inherit from Component.");
+			static_assert(!std::is_base_of<TagBase, T>::value, "Template argument cannot be a Tag");
+
+			Record(ent, Phase::Components, T::GetComponentId(), [constructorParams...](Entity& e) {
+				if (!e.Has<T>())
+				{
+					e.Add<T>(constructorParams...);
+				}
+			});
+		}
+
+		//- Records the removal of a Component.
+		template<class T>
+		void Remove(Entity& ent)
+		{
+			static_assert(std::is_base_of<ComponentBase, T>::value, "Template argument must inherit from Component.");
+			static_assert(!std::is_base_of<TagBase, T>::value, "Template argument cannot be a Tag");
+
+			Record(ent, Phase::Components, T::GetComponentId(), [](Entity& e) {
+				e.RemoveComponent<T>();
+			});
+		}
+
+		//- Records the addition of a Tag.
+		template<class T>
+		void Tag(Entity& ent)
+		{
+			static_assert(std::is_base_of<TagBase, T>::value, "Template argument must inherit from Tag.");
+
+			Record(ent, Phase::Components, T::GetComponentId(), [](Entity& e) {
+				e.Tag<T>();
+			});
+		}
+
+		//- Records the removal of a Tag.
+		template<class T>
+		void RemoveTag(Entity& ent)
+		{
+			static_assert(std::is_base_of<TagBase, T>::value, "Template argument must inherit from Tag.");
+
+			Record(ent, Phase::Components, T::GetComponentId(), [](Entity& e) {
+				e.RemoveTag<T>();
+			});
+		}
+
+		//- Records enabling a Component. The Component must exist at playback time.
+		template<class T>
+		void Enable(Entity& ent)
+		{
+			static_assert(std::is_base_of<ComponentBase, T>::value, "Template argument must inherit from Component.");
+			static_assert(!std::is_base_of<TagBase, T>::value, "Tags cannot be enabled or disabled. Add or remove them instead.");
+
+			Record(ent, Phase::Components, T::GetComponentId(), [](Entity& e) {
+				e.Enable<T>();
+			});
+		}
+
+		//- Records disabling a Component. The Component must exist at playback time.
+		template<class T>
+		void Disable(Entity& ent)
+		{
+			static_assert(std::is_base_of<ComponentBase, T>::value, "Template argument must inherit from Component.");
+			static_assert(!std::is_base_of<TagBase, T>::value, "Tags cannot be enabled or disabled. Add or remove them instead.");
+
+			Record(ent, Phase::Components, T::GetComponentId(), [](Entity& e) {
+				e.Disable<T>();
+			});
+		}
+
+		//- Records enabling the Entity.
+		void Enable(Entity& ent);
+
+		//- Records disabling the Entity.
+		void Disable(Entity& ent);
+
+		//- Records the destruction of the Entity. At playback, it is stripped of all Components and Tags
+		//  and detached from its parent. Its memory is released along with the last Entity::Ptr to it.
+		void Destroy(Entity& ent);
+
+		//- Applies all recorded commands, then clears the buffer.
+		void Playback();
+
+		//- Discards all recorded commands without applying them.
+		void Clear();
+
+		u32 GetNumCommands() const;
+		bool IsEmpty() const;
+
+	private:
+		enum class Phase : u32
+		{
+			Components,
+			Entities,
+			Destroy
+		};
+
+		using Action = InlineFunction<void(Entity&)>;
+
+		struct Command
+		{
+			EntityHandle entity;
+			Phase phase;
+			//- The Component/Tag ID that the command affects, or 0 for whole-Entity commands.
+			u32 id;
+			Action apply;
+		};
+
+		void Record(Entity& ent, Phase phase, u32 id, Action apply);
+
+		std::vector<Command> commands;
+		std::unique_ptr<Mutex> lock;
+	};
+}
@@ -5,41 +5,60 @@
 
 namespace Jwl
 {
+	EntityGroup::EntityGroup(Order _order)
+		: order(_order)
+	{
+	}
+
 	void EntityGroup::Add(Entity::Ptr ent)
 	{
 		ASSERT(ent, "Cannot add a null Entity to an EntityGroup.");
 		ASSERT(!Has(*ent), "Entity is already part of the EntityGroup.");
 
-		entities.push_back(ent);
+		if (entities.IsEmpty())
+		{
+			world = &ent->GetWorld();
+		}
+		ASSERT(&ent->GetWorld() == world, "All Entities of an EntityGroup must belong to the same World.");
+
+		entities.Insert(ent->GetId(), ent);
 	}
 
 	void EntityGroup::Remove(const Entity& ent)
 	{
-		for (u32 i = 0; i < entities.size(); i++)
+		// IDs are only unique within a World.
+		if (&ent.GetWorld() != world)
 		{
-			if (entities[i].get() == &ent)
-			{
-				entities.erase(entities.begin() + i);
-				return;
-			}
+			return;
 		}
-	}
 
-	bool EntityGroup::Has(const Entity& ent) const
-	{
-		for (auto& entity : entities)
+		if (order == Order::Stable)
+		{
+			entities.RemoveOrdered(ent.GetId());
+		}
+		else
 		{
-			if (entity.get() == &ent)
-			{
-				return true;
-			}
+			entities.Remove(ent.GetId());
 		}
+	}
 
-		return false;
+	bool EntityGroup::Has(const Entity& ent) const
+	{
+		return &ent.GetWorld() == world && entities.Contains(ent.GetId());
 	}
 
 	void EntityGroup::Clear()
 	{
-		entities.clear();
+		entities.Clear();
+	}
+
+	u32 EntityGroup::Size() const
+	{
+		return entities.Size();
+	}
+
+	EntityGroup::Order EntityGroup::GetOrder() const
+	{
+		return order;
 	}
 }
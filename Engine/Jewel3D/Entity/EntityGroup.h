@@ -1,15 +1,29 @@
 // Copyright (c) 2017 Emilian Cioca
 #pragma once
 #include "Entity.h"
+#include "Jewel3D/Utilities/SparseSet.h"
 
 #include <vector>
 
 namespace Jwl
 {
 	//- Represents a list of Entities to be associated together.
+	//- The Entities are kept in a dense array, indexed by their IDs, so Add(), Remove() and Has() are O(1).
+	//! All Entities of a group must belong to the same World.
 	class EntityGroup
 	{
 	public:
+		enum class Order
+		{
+			//- Removal moves the last Entity into the vacated position. The fastest option.
+			Unordered,
+			//- The Entities are kept in the order that they were added, such as for a consistent draw order.
+			//- Removal is O(n) in the number of Entities added after the removed one.
+			Stable
+		};
+
+		explicit EntityGroup(Order order = Order::Unordered);
+
 		void Add(Entity::Ptr ent);
 		void Remove(const Entity& ent);
 
@@ -17,9 +31,16 @@ namespace Jwl
 		
 		void Clear();
 
-		const auto& GetEntities() const { return entities; }
+		u32 Size() const;
+		Order GetOrder() const;
+
+		const std::vector<Entity::Ptr>& GetEntities() const { return entities.GetValues(); }
 
 	private:
-		std::vector<Entity::Ptr> entities;
+		//- The members of the group, by their Entity IDs.
+		SparseSet<Entity::Ptr> entities;
+		//- The World that the members belong to, if there are any.
+		const World* world = nullptr;
+		Order order;
 	};
 }
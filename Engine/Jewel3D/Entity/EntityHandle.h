@@ -0,0 +1,103 @@
+// Copyright (c) 2017 Emilian Cioca
+#pragma once
+#include "Jewel3D/Application/Logging.h"
+#include "Jewel3D/Application/Types.h"
+#include "Jewel3D/Entity/World.h"
+
+#include <functional>
+
+namespace Jwl
+{
+	//- A compact, non-owning reference to an Entity.
+	//- Unlike Entity::Ptr, copying a handle involves no reference counting. A handle does not keep its
+	//  Entity alive, but it can tell in constant time whether the Entity still exists.
+	//- Handles remain unique over time even though Entity IDs are recycled, because each reuse of an ID
+	//  increments its generation. The packed 64-bit value is suitable for serialization or networking.
+	//- A handle also records the World of its Entity, so handles from different Worlds never collide,
+	//  even when a World reuses the index of one that was destroyed.
+	class EntityHandle
+	{
+	public:
+		//- The last generation of an Entity ID. IDs are retired rather than wrapping around, so handles never resolve to a later Entity.
+		static constexpr u32 MaxGeneration = 0xFFFFFF;
+
+		//- Constructs a null handle.
+		EntityHandle()
+			: generation(0), world(0)
+		{}
+		EntityHandle(u32 _index, u32 _generation, u32 _world = 0)
+			: index(_index), generation(_generation), world(_world)
+		{}
+
+		//- Constructs a handle from a value returned by GetValue().
+		explicit EntityHandle(u64 value)
+			: index(static_cast<u32>(value))
+			, generation(static_cast<u32>(value >> 32) & MaxGeneration)
+			, world(static_cast<u32>(value >> 56))
+		{}
+
+		//- Returns the Entity if it is still alive, otherwise null.
+		Entity* Get() const
+		{
+			const World* owner = detail::worlds[world];
+			if (owner && index < owner->entitySlots.size())
+			{
+				auto& slot = owner->entitySlots[index];
+				if (slot.generation == generation)
+				{
+					return slot.entity;
+				}
+			}
+
+			return nullptr;
+		}
+
+		//- Returns true if the Entity is still alive.
+		bool IsValid() const { return Get() != nullptr; }
+		explicit operator bool() const { return IsValid(); }
+
+		Entity& operator*() const
+		{
+			Entity* ent = Get();
+			ASSERT(ent, "Dereferencing an EntityHandle whose Entity no longer exists.");
+			return *ent;
+		}
+
+		Entity* operator->() const
+		{
+			Entity* ent = Get();
+			ASSERT(ent, "Dereferencing an EntityHandle whose Entity no longer exists.");
+			return ent;
+		}
+
+		bool operator==(const EntityHandle& other) const { return GetValue() == other.GetValue(); }
+		bool operator!=(const EntityHandle& other) const { return !operator==(other); }
+
+		//- The ID of the Entity.
+		u32 GetIndex() const { return index; }
+		u32 GetGeneration() const { return generation; }
+		//- The index of the World that the Entity belongs to.
+		u32 GetWorldIndex() const { return world; }
+
+		//- Packs the handle into a single value.
+		u64 GetValue() const { return static_cast<u64>(world) << 56 | static_cast<u64>(generation) << 32 | index; }
+
+	private:
+		u32 index = 0;
+		//- Live generations start at 1, so a default handle never resolves.
+		u32 generation : 24;
+		u32 world : 8;
+	};
+}
+
+namespace std
+{
+	template<>
+	struct hash<Jwl::EntityHandle>
+	{
+		size_t operator()(const Jwl::EntityHandle& handle) const
+		{
+			return hash<Jwl::u64>()(handle.GetValue());
+		}
+	};
+}
@@ -1,89 +1,277 @@
 // Copyright (c) 2017 Emilian Cioca
 #include "Jewel3D/Precompiled.h"
 #include "Name.h"
+#include "Jewel3D/Application/Threading.h"
 
-namespace Jwl
+#include <algorithm>
+#include <unordered_set>
+
+namespace
 {
-	void LogSceneGraphRecursive(const Entity& entity, u32 tabLevel)
+	//- Owns every interned string.
+	struct StringTable
 	{
-		std::string output;
-		output.append(tabLevel * 2, ' ');
-
-		if (auto nameComp = entity.Try<Name>())
+		StringTable()
 		{
-			output += "|- " + nameComp->name;
+			bool result = lock.Init();
+			ASSERT(result, "NameId: Failed to create mutex.");
 		}
-		else
+
+		Jwl::Mutex lock;
+		std::unordered_set<std::string> strings;
+	};
+
+	StringTable& GetStringTable()
+	{
+		// Never destroyed, since the interned strings might still be referenced by static Entities.
+		static StringTable* table = new StringTable();
+		return *table;
+	}
+
+	const std::string emptyString;
+}
+
+namespace Jwl
+{
+	NameId::NameId(const std::string& _str)
+	{
+		if (_str.empty())
 		{
-			output += "|- NO_NAME";
+			return;
 		}
 
-		Log(output);
+		auto& table = GetStringTable();
+		table.lock.Lock();
+		str = &*table.strings.insert(_str).first;
+		table.lock.Unlock();
+	}
 
-		for (auto& child : entity.GetChildren())
+	bool NameId::Find(const std::string& _str, NameId& out)
+	{
+		if (_str.empty())
 		{
-			LogSceneGraphRecursive(*child, tabLevel + 1);
+			out = NameId();
+			return true;
 		}
+
+		auto& table = GetStringTable();
+		table.lock.Lock();
+		auto itr = table.strings.find(_str);
+		const bool found = itr != table.strings.end();
+		if (found)
+		{
+			out.str = &*itr;
+		}
+		table.lock.Unlock();
+
+		return found;
 	}
 
-	void LogSceneGraph(const Entity& root)
+	const std::string& NameId::GetString() const
 	{
-		LogSceneGraphRecursive(root, 0);
+		return str ? *str : emptyString;
 	}
 
-	Entity::Ptr FindChild(const Entity& root, const std::string& name)
+	bool NameId::operator==(NameId other) const
+	{
+		return str == other.str;
+	}
+
+	bool NameId::operator!=(NameId other) const
 	{
-		for (auto& child : root.GetChildren())
+		return str != other.str;
+	}
+
+	void LogSceneGraph(const Entity& root)
+	{
+		const u32 rootDepth = root.GetDepth();
+
+		for (auto& entity : root.GetSubtree())
 		{
-			auto nameComp = child->Try<Name>();
-			if (nameComp && nameComp->name == name)
+			std::string output;
+			output.append((entity.GetDepth() - rootDepth) * 2, ' ');
+
+			if (auto nameComp = entity.Try<Name>())
 			{
-				return child;
+				output += "|- " + nameComp->GetName();
 			}
+			else
+			{
+				output += "|- NO_NAME";
+			}
+
+			Log(output);
 		}
-		
-		for (auto& child : root.GetChildren())
+	}
+
+	Entity::Ptr FindChild(const Entity& root, const std::string& name)
+	{
+		NameId id;
+		if (!NameId::Find(name, id))
 		{
-			if (auto result = FindChild(*child, name))
+			return nullptr;
+		}
+
+		return FindChild(root, id);
+	}
+
+	Entity::Ptr FindChild(const Entity& root, NameId name)
+	{
+		auto named = Name::GetIndexed(root.GetWorld(), name);
+		if (!named)
+		{
+			return nullptr;
+		}
+
+		// Rather than searching the sub-tree, check which of the named Entities are descendants of the root.
+		// The cached depths tell exactly how far up the root would be.
+		const u32 rootDepth = root.GetDepth();
+		Entity* result = nullptr;
+		u32 resultDepth = ~0u;
+		for (Name* comp : *named)
+		{
+			const u32 depth = comp->owner.GetDepth();
+			if (depth <= rootDepth || depth >= resultDepth)
+			{
+				continue;
+			}
+
+			Entity* ancestor = comp->owner.GetParentNode();
+			for (u32 i = depth - 1; i > rootDepth; --i)
 			{
-				return result;
+				ancestor = ancestor->GetParentNode();
+			}
+
+			if (ancestor == &root)
+			{
+				result = &comp->owner;
+				resultDepth = depth;
 			}
 		}
 
-		return nullptr;
+		return result ? result->GetPtr() : nullptr;
 	}
 
-	Entity::Ptr FindEntity(const std::string& name)
+	Entity::Ptr FindEntity(const std::string& name, World& world)
 	{
-		Entity::Ptr result;
+		NameId id;
+		if (!NameId::Find(name, id))
+		{
+			return nullptr;
+		}
 
-		for (auto& comp : All<Name>())
+		return FindEntity(id, world);
+	}
+
+	Entity::Ptr FindEntity(NameId name, World& world)
+	{
+		auto named = Name::GetIndexed(world, name);
+		if (!named)
 		{
-			if (comp.name == name)
+			return nullptr;
+		}
+
+		// Disabled Names remain in the index, so that enabling and disabling Entities does not have to update it.
+		for (Name* comp : *named)
+		{
+			if (comp->IsEnabled())
 			{
-				result = comp.owner.GetPtr();
-				break;
+				return comp->owner.GetPtr();
 			}
 		}
 
-		return result;
+		return nullptr;
 	}
 
 	Name::Name(Entity& _owner)
 		: Component(_owner)
 	{
+		Register();
 	}
 
 	Name::Name(Entity& _owner, const std::string& _name)
 		: Component(_owner)
 		, name(_name)
 	{
+		Register();
+	}
+
+	Name::Name(Entity& _owner, NameId _name)
+		: Component(_owner)
+		, name(_name)
+	{
+		Register();
 	}
 
 	Name& Name::operator=(const Name& other)
 	{
-		name = other.name + "_Copy";
+		SetName(other.name.GetString() + "_Copy");
 
 		return *this;
 	}
+
+	Name::~Name()
+	{
+		Unregister();
+	}
+
+	void Name::SetName(const std::string& _name)
+	{
+		SetName(NameId(_name));
+	}
+
+	void Name::SetName(NameId _name)
+	{
+		if (name == _name)
+		{
+			return;
+		}
+
+		Unregister();
+		name = _name;
+		Register();
+	}
+
+	const std::string& Name::GetName() const
+	{
+		return name.GetString();
+	}
+
+	NameId Name::GetNameId() const
+	{
+		return name;
+	}
+
+	const std::vector<Name*>* Name::GetIndexed(World& world, NameId name)
+	{
+		auto itr = world.nameIndex.find(name.str);
+		if (itr == world.nameIndex.end())
+		{
+			return nullptr;
+		}
+
+		return &itr->second;
+	}
+
+	void Name::Register()
+	{
+		owner.GetWorld().nameIndex[name.str].push_back(this);
+	}
+
+	void Name::Unregister()
+	{
+		auto& index = owner.GetWorld().nameIndex;
+		auto itr = index.find(name.str);
+		ASSERT(itr != index.end(), "Name was not registered with its World.");
+
+		auto& named = itr->second;
+		auto pos = std::find(named.begin(), named.end(), this);
+		*pos = named.back();
+		named.pop_back();
+
+		if (named.empty())
+		{
+			index.erase(itr);
+		}
+	}
 }
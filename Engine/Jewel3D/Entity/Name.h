@@ -3,27 +3,76 @@
 #include "Jewel3D/Entity/Entity.h"
 
 #include <string>
+#include <vector>
 
 namespace Jwl
 {
+	class Name;
+
+	//- An interned string. Equal strings always share the same NameId, so comparing two of them is as cheap as comparing pointers.
+	//- Interned strings are never released. Only intern strings that are reused, such as the names of Entities.
+	//- Interning is thread-safe.
+	class NameId
+	{
+		friend Name;
+	public:
+		//- The ID of the empty string.
+		NameId() = default;
+		//- Interns the string, if it isn't already, and returns its ID.
+		explicit NameId(const std::string& str);
+
+		//- Retrieves the ID of the string without interning it. Returns false if the string was never interned.
+		static bool Find(const std::string& str, NameId& out);
+
+		const std::string& GetString() const;
+
+		bool operator==(NameId other) const;
+		bool operator!=(NameId other) const;
+
+	private:
+		//- The interned copy of the string. Null for the empty string.
+		const std::string* str = nullptr;
+	};
+
 	//- Writes the sub-tree of Entity names to the program log.
 	void LogSceneGraph(const Entity& root);
 
-	//- Searches the given entity's sub-tree for the first child with the specified name.
+	//- Searches the given entity's sub-tree for the child with the specified name.
+	//- If there are several, the one closest to the root is returned.
 	Entity::Ptr FindChild(const Entity& root, const std::string& name);
+	Entity::Ptr FindChild(const Entity& root, NameId name);
 
-	//- Searches all Entities with a name component and returns the first one found with the specified name.
-	Entity::Ptr FindEntity(const std::string& name);
+	//- Returns an enabled Entity of the World with the specified name, if there is one.
+	Entity::Ptr FindEntity(const std::string& name, World& world = World::GetDefault());
+	Entity::Ptr FindEntity(NameId name, World& world = World::GetDefault());
 
-	//- Associates an entity with a name. Used by LogSceneGraph() and FindEntity().
+	//- Associates an entity with a name. Used by LogSceneGraph(), FindChild(), and FindEntity().
+	//- Each World keeps an index of the Names of its Entities, so that they can be found without any searching.
 	//- When copied, appends "_Copy" to the name.
 	class Name : public Component<Name>
 	{
+		friend Entity::Ptr FindChild(const Entity&, NameId);
+		friend Entity::Ptr FindEntity(NameId, World&);
 	public:
 		Name(Entity& owner);
 		Name(Entity& owner, const std::string& name);
+		Name(Entity& owner, NameId name);
 		Name& operator=(const Name&);
+		~Name();
+
+		void SetName(const std::string& name);
+		void SetName(NameId name);
+
+		const std::string& GetName() const;
+		NameId GetNameId() const;
+
+	private:
+		//- Returns every Name of the World using the specified name, or null if there are none.
+		static const std::vector<Name*>* GetIndexed(World& world, NameId name);
+
+		void Register();
+		void Unregister();
 
-		std::string name;
+		NameId name;
 	};
 }
@@ -0,0 +1,232 @@
+// Copyright (c) 2017 Emilian Cioca
+#include "Jewel3D/Precompiled.h"
+#include "Prefab.h"
+#include "Name.h"
+#include "Jewel3D/Rendering/Material.h"
+
+#include <unordered_map>
+
+namespace
+{
+	//- Returns the Components of the Entity in the order that they should be copied.
+	//- The material is always copied first, as in Entity::Duplicate(), in order to have the
+	//  Shader Variants updated from any of the new components initializing.
+	std::vector<Jwl::ComponentBase*> GetCopyOrder(const Jwl::Entity& ent, const std::vector<Jwl::ComponentBase*>& components)
+	{
+		std::vector<Jwl::ComponentBase*> result;
+		result.reserve(components.size());
+
+		auto material = ent.Try<Jwl::Material>();
+		if (material)
+		{
+			result.push_back(material);
+		}
+
+		for (auto comp : components)
+		{
+			if (comp != material)
+			{
+				result.push_back(comp);
+			}
+		}
+
+		return result;
+	}
+}
+
+namespace Jwl
+{
+	Prefab::Prefab(const Entity& source)
+	{
+		World& world = source.GetWorld();
+
+		// Depth-first, so that parents are always compiled before their children.
+		std::vector<std::pair<const Entity*, s32>> stack = { { &source, -1 } };
+		while (!stack.empty())
+		{
+			auto current = stack.back();
+			stack.pop_back();
+
+			auto snapshot = world.CreateEntity();
+			snapshot->isEnabled = false;
+			snapshot->SetLocalTransform(current.first->localTransform);
+			CopyComponents(*current.first, *snapshot);
+
+			nodes.push_back({ snapshot, current.second, current.first->IsEnabled() });
+
+			// Pushed in reverse so that children keep their order.
+			const s32 index = nodes.size() - 1;
+			auto& children = current.first->GetChildren();
+			for (auto itr = children.rbegin(); itr != children.rend(); ++itr)
+			{
+				stack.emplace_back(itr->get(), index);
+			}
+		}
+	}
+
+	Entity::Ptr Prefab::Instantiate(World& world) const
+	{
+		return Instantiate(1, world)[0];
+	}
+
+	std::vector<Entity::Ptr> Prefab::Instantiate(u32 count, World& world) const
+	{
+		if (count == 0)
+		{
+			return {};
+		}
+
+		const u32 numNodes = nodes.size();
+
+		// Reserve the tables up front, so that they don't repeatedly reallocate as the copies are indexed.
+		std::unordered_map<u32, u32> numIndexed;
+		for (auto& node : nodes)
+		{
+			if (!node.isEnabled)
+			{
+				continue;
+			}
+
+			for (auto comp : node.snapshot->components)
+			{
+				if (comp->isEnabled)
+				{
+					numIndexed[comp->componentId] += count;
+				}
+			}
+
+			for (u32 tag : node.snapshot->tags)
+			{
+				numIndexed[tag] += count;
+			}
+		}
+
+		for (auto& pair : numIndexed)
+		{
+			auto& table = world.entityIndex[pair.first];
+			table.Reserve(table.Size() + pair.second);
+		}
+
+		world.entitySlots.reserve(world.entitySlots.size() + count * numNodes);
+
+		// Build every copy while it is disabled, so that nothing is indexed yet.
+		// The copies of each node are stored together, since they are processed together.
+		std::vector<Entity::Ptr> entities(count * numNodes);
+		for (u32 n = 0; n < numNodes; ++n)
+		{
+			auto& node = nodes[n];
+			for (u32 i = 0; i < count; ++i)
+			{
+				auto ent = world.CreateEntity();
+				ent->isEnabled = false;
+				ent->SetLocalTransform(node.snapshot->localTransform);
+				ent->components.reserve(node.snapshot->components.size());
+				ent->tags.reserve(node.snapshot->tags.size());
+
+				if (node.parent >= 0)
+				{
+					entities[node.parent * count + i]->AddChild(ent);
+				}
+
+				entities[n * count + i] = std::move(ent);
+			}
+		}
+
+		// Copy one Component type at a time, across all copies of a node.
+		for (u32 n = 0; n < numNodes; ++n)
+		{
+			auto& snapshot = *nodes[n].snapshot;
+			Entity::Ptr* copies = &entities[n * count];
+
+			for (auto comp : GetCopyOrder(snapshot, snapshot.components))
+			{
+				for (u32 i = 0; i < count; ++i)
+				{
+					CopyComponent(*comp, *copies[i]);
+				}
+			}
+
+			for (u32 tag : snapshot.tags)
+			{
+				for (u32 i = 0; i < count; ++i)
+				{
+					copies[i]->Tag(tag);
+				}
+			}
+		}
+
+		// Finally, enable the copies by updating each table of the index in a single pass.
+		for (u32 n = 0; n < numNodes; ++n)
+		{
+			auto& node = nodes[n];
+			if (!node.isEnabled)
+			{
+				continue;
+			}
+
+			Entity::Ptr* copies = &entities[n * count];
+			for (auto comp : node.snapshot->components)
+			{
+				if (!comp->isEnabled)
+				{
+					continue;
+				}
+
+				for (u32 i = 0; i < count; ++i)
+				{
+					copies[i]->Index(*copies[i]->lookup.Get(comp->componentId));
+				}
+			}
+
+			for (u32 tag : node.snapshot->tags)
+			{
+				for (u32 i = 0; i < count; ++i)
+				{
+					copies[i]->IndexTag(tag);
+				}
+			}
+
+			for (u32 i = 0; i < count; ++i)
+			{
+				copies[i]->isEnabled = true;
+			}
+		}
+
+		entities.resize(count);
+		return entities;
+	}
+
+	u32 Prefab::GetNumEntities() const
+	{
+		return nodes.size();
+	}
+
+	void Prefab::CopyComponents(const Entity& source, Entity& destination)
+	{
+		for (auto comp : GetCopyOrder(source, source.components))
+		{
+			CopyComponent(*comp, destination);
+		}
+
+		for (u32 tag : source.tags)
+		{
+			destination.Tag(tag);
+		}
+	}
+
+	void Prefab::CopyComponent(const ComponentBase& source, Entity& destination)
+	{
+		source.Copy(destination);
+
+		// The copy is made from a disabled Entity, so its own state must be restored directly.
+		if (ComponentBase* copy = destination.lookup.Get(source.componentId))
+		{
+			copy->isEnabled = source.isEnabled;
+
+			if (source.componentId == Name::GetComponentId())
+			{
+				static_cast<Name*>(copy)->SetName(static_cast<const Name&>(source).GetNameId());
+			}
+		}
+	}
+}
@@ -0,0 +1,52 @@
+// Copyright (c) 2017 Emilian Cioca
+#pragma once
+#include "Entity.h"
+
+#include <vector>
+
+namespace Jwl
+{
+	//- A template compiled from an Entity and all of its descendants, which can be instantiated many times at once.
+	//- The prefab takes a snapshot of the subtree when it is created. Later changes to the source are not reflected.
+	//- Instantiating many copies at once is much faster than calling Entity::Duplicate() repeatedly. The index tables
+	//  are reserved up front, the Components are copied one type at a time, and each table of the index is updated
+	//  in a single pass once all copies have been built.
+	//- Copies keep the names of the source Entities, rather than gaining a "_Copy" suffix.
+	class Prefab
+	{
+	public:
+		//- Compiles the prefab from the current state of the Entity and its descendants.
+		explicit Prefab(const Entity& source);
+		Prefab(const Prefab&) = delete;
+		Prefab& operator=(const Prefab&) = delete;
+
+		//- Creates one copy of the prefab in the World and returns the copy of the root.
+		Entity::Ptr Instantiate(World& world = World::GetDefault()) const;
+
+		//- Creates 'count' copies of the prefab in the World and returns the copy of the root of each.
+		std::vector<Entity::Ptr> Instantiate(u32 count, World& world = World::GetDefault()) const;
+
+		//- The number of Entities in each copy.
+		u32 GetNumEntities() const;
+
+	private:
+		struct Node
+		{
+			//- A hidden copy of the source Entity, holding the state of its Components.
+			//- It is kept disabled so that it never shows up in queries.
+			Entity::Ptr snapshot;
+			//- The position of the parent node, or -1 for the root. Parents always come before their children.
+			s32 parent;
+			//- Whether or not the source Entity was enabled.
+			bool isEnabled;
+		};
+
+		//- Copies the Components and Tags of the source onto the destination, which must not have any yet.
+		//- Component states are copied without indexing anything.
+		static void CopyComponents(const Entity& source, Entity& destination);
+		static void CopyComponent(const ComponentBase& source, Entity& destination);
+
+		//- The subtree in depth-first order.
+		std::vector<Node> nodes;
+	};
+}
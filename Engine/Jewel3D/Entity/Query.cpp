@@ -0,0 +1,80 @@
+// Copyright (c) 2017 Emilian Cioca
+#include "Jewel3D/Precompiled.h"
+#include "Entity.h"
+
+#include <algorithm>
+
+namespace Jwl
+{
+	namespace detail
+	{
+		QueryBase::QueryBase(World& _world, std::vector<u32> _ids)
+			: world(_world)
+			, ids(std::move(_ids))
+		{
+			std::sort(ids.begin(), ids.end());
+			ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+			for (u32 id : ids)
+			{
+				tables.push_back(&world.entityIndex[id]);
+				world.queryIndex[id].push_back(this);
+			}
+
+			// Gather the initial results by probing the other tables with each Entity of the smallest.
+			auto smallest = *std::min_element(tables.begin(), tables.end(), [](auto* a, auto* b) {
+				return a->Size() < b->Size();
+			});
+
+			matches.Reserve(smallest->Size());
+			for (u32 i = 0; i < smallest->Size(); i++)
+			{
+				if (IsMatch(smallest->GetKey(i)))
+				{
+					matches.Insert(smallest->GetKey(i), (*smallest)[i]);
+				}
+			}
+		}
+
+		QueryBase::~QueryBase()
+		{
+			for (u32 id : ids)
+			{
+				auto& observers = world.queryIndex[id];
+				observers.erase(std::find(observers.begin(), observers.end(), this));
+			}
+		}
+
+		bool QueryBase::Contains(const Entity& ent) const
+		{
+			// IDs are only unique within a World.
+			return &ent.GetWorld() == &world && matches.Contains(ent.GetId());
+		}
+
+		void QueryBase::OnIndexed(Entity& ent)
+		{
+			if (!matches.Contains(ent.GetId()) && IsMatch(ent.GetId()))
+			{
+				matches.Insert(ent.GetId(), &ent);
+			}
+		}
+
+		void QueryBase::OnUnindexed(const Entity& ent)
+		{
+			matches.Remove(ent.GetId());
+		}
+
+		bool QueryBase::IsMatch(u32 entityId) const
+		{
+			for (auto table : tables)
+			{
+				if (!table->Contains(entityId))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+	}
+}
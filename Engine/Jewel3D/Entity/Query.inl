@@ -1,28 +1,91 @@
 // Copyright (c) 2017 Emilian Cioca
 namespace Jwl
 {
+	//- Used as an argument to With<>() to only match Entities whose Component of type T has changed
+	//  since the specified change version. For example:
+	//	for (Entity& e : With<Changed<Health>, Player>(lastUpdateVersion)) { ... }
+	//- Components are flagged as changed when they are added, and whenever MarkChanged() is called.
+	template<class T>
+	struct Changed
+	{
+		static_assert(std::is_base_of<ComponentBase, T>::value, "Template argument must be a Component.");
+		static_assert(!std::is_base_of<TagBase, T>::value, "Tags cannot be changed. Query for them directly instead.");
+	};
+
 	namespace detail
 	{
-		//- Index of all Entities for each component and tag type. Used to power the queries.
-		//- Sorted to allow for logical operations, such as ANDing, between multiple tables in the index.
-		extern std::unordered_map<unsigned, std::vector<Entity*>> entityIndex;
-		//- Index of all Components of a particular type. Used to power the queries.
-		//- Not sorted since no logical operations are performed using these tables.
-		extern std::unordered_map<unsigned, std::vector<ComponentBase*>> componentIndex;
-		
-		//- Enumerates a table of the componentIndex while performing a cast and a dereference.
+		//- Resolves the Component/Tag type of an argument to With<>(), unwrapping Changed<>.
+		template<class Arg>
+		struct QueryArg
+		{
+			using Type = Arg;
+			static u32 GetChangedId() { return 0; }
+		};
+
+		template<class T>
+		struct QueryArg<Changed<T>>
+		{
+			using Type = T;
+			static u32 GetChangedId() { return T::GetComponentId(); }
+		};
+
+		//- Restricts an IntersectionIterator to Entities with Components that have changed since a version.
+		template<u32 NumTables>
+		struct ChangeFilter
+		{
+			//- The IDs of the Components that must have changed. Only the first 'count' are used.
+			std::array<u32, NumTables> ids = {};
+			u32 count = 0;
+			u64 since = 0;
+
+			bool Accepts(const Entity& ent) const
+			{
+				for (u32 i = 0; i < count; ++i)
+				{
+					if (!ent.lookup.Get(ids[i])->HasChangedSince(since))
+					{
+						return false;
+					}
+				}
+
+				return true;
+			}
+		};
+
+		//- Builds the ChangeFilter for the arguments of a query.
+		template<typename... Args>
+		ChangeFilter<sizeof...(Args)> MakeChangeFilter(u64 since)
+		{
+			ChangeFilter<sizeof...(Args)> filter;
+			filter.since = since;
+			for (u32 id : { QueryArg<Args>::GetChangedId()... })
+			{
+				if (id != 0)
+				{
+					filter.ids[filter.count++] = id;
+				}
+			}
+
+			return filter;
+		}
+
+		//- Enumerates the active Components of a componentStorage table while performing a cast and a dereference.
+		//- Each storage of the table is swept chunk by chunk, in memory order.
 		template<class Component>
 		class ComponentIterator : public std::iterator<std::forward_iterator_tag, Component>
 		{
-			using Iterator = std::vector<ComponentBase*>::iterator;
+			using Table = std::vector<ComponentStorage*>;
 		public:
-			ComponentIterator(Iterator _itr)
-				: itr(_itr)
-			{}
+			ComponentIterator(const Table& _table, u32 _storage)
+				: table(&_table), storage(_storage)
+			{
+				FindActive();
+			}
 
 			ComponentIterator& operator++()
 			{
-				++itr;
+				++index;
+				FindActive();
 				return *this;
 			}
 
@@ -35,324 +98,396 @@ namespace Jwl
 
 			Component& operator*() const
 			{
-				return *static_cast<Component*>(*itr);
+				return *static_cast<Component*>((*table)[storage]->GetComponent(chunk, index));
 			}
 
 			Component* operator->() const
 			{
-				return static_cast<Component*>(*itr);
+				return static_cast<Component*>((*table)[storage]->GetComponent(chunk, index));
 			}
 
 			bool operator==(const ComponentIterator& other) const
 			{
-				return itr == other.itr;
+				return storage == other.storage && chunk == other.chunk && index == other.index;
 			}
 
 			bool operator!=(const ComponentIterator& other) const
 			{
-				return itr != other.itr;
+				return !operator==(other);
 			}
 
 		private:
-			//- The current position in the target table.
-			Iterator itr;
+			//- Advances to the next active instance, starting from the current position.
+			void FindActive()
+			{
+				for (; storage < table->size(); ++storage, chunk = 0)
+				{
+					auto& current = *(*table)[storage];
+
+					for (; chunk < current.GetNumChunks(); ++chunk, index = 0)
+					{
+						const u32 size = current.GetChunkSize(chunk);
+						for (; index < size; ++index)
+						{
+							if (current.IsActive(chunk, index))
+							{
+								return;
+							}
+						}
+					}
+				}
+
+				// Normalize to the end position.
+				chunk = 0;
+				index = 0;
+			}
+
+			//- The table being enumerated.
+			const Table* table;
+			//- The current position in the table.
+			u32 storage;
+			u32 chunk = 0;
+			u32 index = 0;
 		};
 
-		//- A safe iterator used to enumerate the entityIndex tables.
-		//- Although it models a single iterator, it knows when it has reached the end of the table.
-		class SafeIterator : public std::iterator<std::forward_iterator_tag, Entity*>
+		//- Enumerates the Entities of an entityIndex table which are also present in a number of other tables.
+		//- The first table drives the iteration while the others are probed, in constant time, for each candidate.
+		//- The tables should be ordered by size with OrderBySize(), so that the fewest candidates are considered.
+		//- Candidates can additionally be filtered by the change versions of their Components.
+		template<u32 NumTables>
+		class IntersectionIterator : public std::iterator<std::forward_iterator_tag, Entity>
 		{
-			using Iterator = std::vector<Entity*>::iterator;
 		public:
-			SafeIterator(Iterator _itr, const Iterator _itrEnd)
-				: itr(_itr), itrEnd(_itrEnd)
-			{}
+			using Tables = std::array<const EntityTable*, NumTables>;
 
-			SafeIterator& operator++()
+			//- Only considers the positions of the first table before 'last'. Used to partition the range.
+			IntersectionIterator(const Tables& _tables, u32 _position, u32 _last)
+				: tables(_tables), position(_position), last(_last)
 			{
-				ASSERT(!IsTerminated(), "Iterator cannot be incremented. Check for invalid usage of With<>().");
-				++itr;
+				FindMatch();
+			}
+
+			IntersectionIterator(const Tables& _tables, u32 _position, const ChangeFilter<NumTables>& _filter)
+				: tables(_tables), filter(_filter), position(_position)
+			{
+				FindMatch();
+			}
+
+			IntersectionIterator& operator++()
+			{
+				ASSERT(position < tables[0]->Size(), "Iterator cannot be incremented. Check for invalid usage of With<>().");
+				++position;
+				FindMatch();
 				return *this;
 			}
 
-			SafeIterator operator++(int)
+			IntersectionIterator operator++(int)
 			{
-				ASSERT(!IsTerminated(), "Iterator cannot be incremented. Check for invalid usage of With<>().");
-				SafeIterator result(*this);
+				IntersectionIterator result(*this);
 				operator++();
 				return result;
 			}
 
 			Entity& operator*() const
 			{
-				ASSERT(!IsTerminated(), "Iterator cannot be dereferenced. Check for invalid usage of With<>().");
-				return *(*itr);
+				ASSERT(position < tables[0]->Size(), "Iterator cannot be dereferenced. Check for invalid usage of With<>().");
+				return *(*tables[0])[position];
 			}
 
 			Entity* operator->() const
 			{
-				ASSERT(!IsTerminated(), "Iterator cannot be dereferenced. Check for invalid usage of With<>().");
-				return *itr;
+				ASSERT(position < tables[0]->Size(), "Iterator cannot be dereferenced. Check for invalid usage of With<>().");
+				return (*tables[0])[position];
 			}
 
-			bool operator==(const SafeIterator& other) const
+			bool operator==(const IntersectionIterator& other) const
 			{
-				ASSERT(itrEnd == other.itrEnd, 
+				ASSERT(tables[0] == other.tables[0],
 					"Comparison between iterators of different index tables. Check for invalid usage of With<>().");
-				return itr == other.itr;
+				return position == other.position;
 			}
 
-			bool operator!=(const SafeIterator& other) const
+			bool operator!=(const IntersectionIterator& other) const
 			{
-				ASSERT(itrEnd == other.itrEnd, 
-					"Comparison between iterators of different index tables. Check for invalid usage of With<>().");
-				return itr != other.itr;
+				return !operator==(other);
 			}
 
-			Entity* Get() const
-			{
-				ASSERT(!IsTerminated(), "Iterator is invalid. Check for invalid usage of With<>().");
-				return *itr;
-			}
+			//- The current position in the first table. Used to partition the range.
+			u32 GetPosition() const { return position; }
 
-			bool IsTerminated() const
+		private:
+			//- Advances to the next Entity of the first table which is present in all the others.
+			void FindMatch()
 			{
-				return itr == itrEnd;
-			}
+				const EntityTable& driver = *tables[0];
+				const u32 end = std::min<u32>(last, driver.Size());
 
-			void Terminate()
-			{
-				itr = itrEnd;
+				for (; position < end; ++position)
+				{
+					if (IsInAllTables(driver.GetKey(position)) && filter.Accepts(*driver[position]))
+					{
+						return;
+					}
+				}
 			}
 
-		private:
-			//- The current position in the table.
-			Iterator itr;
-			//- This is required to ensure we don't surpass the table while we are skipping items.
-			const Iterator itrEnd;
-		};
-
-		//- Provides functions to advance two SafeIterators as a logical AND of two entityIndex tables.
-		//- This provider pattern will allow us to add more operations in the future.
-		struct Intersection
-		{
-			static void FindFirst(SafeIterator& itr1, SafeIterator& itr2)
+			bool IsInAllTables(u32 entityId) const
 			{
-				while (!(itr1.IsTerminated() || itr2.IsTerminated()) && itr1.Get() != itr2.Get())
+				for (u32 i = 1; i < NumTables; ++i)
 				{
-					if (itr1.Get() < itr2.Get())
+					if (!tables[i]->Contains(entityId))
 					{
-						++itr1;
-					}
-					else
-					{
-						++itr2;
+						return false;
 					}
 				}
 
-				// Kill the iterators if any reached their end.
-				if (itr1.IsTerminated())
-				{
-					itr2.Terminate();
-				}
-				else if (itr2.IsTerminated())
-				{
-					itr1.Terminate();
-				}
+				return true;
 			}
 
-			static void FindNext(SafeIterator& itr1, SafeIterator& itr2)
-			{
-				FindFirst(++itr1, itr2);
-			}
+			//- The tables being intersected.
+			Tables tables;
+			ChangeFilter<NumTables> filter;
+			//- The current position in the first table.
+			u32 position;
+			//- The search for matches stops here, or at the end of the first table.
+			u32 last = ~0u;
 		};
 
-		//- Enumerates a SafeIterator and a templated iterator while performing a logical operation between them.
-		//- The templated iterator expands into a subtree of more LogicalIterators.
-		template<class Iterator, class Operation>
-		class LogicalIterator : public std::iterator<std::forward_iterator_tag, Entity*>
+		//- Enumerates a subtree of Entities, depth-first, stopping at those present in all of the tables.
+		//- Candidates can additionally be filtered by the change versions of their Components.
+		template<u32 NumTables>
+		class SubtreeIntersectionIterator : public std::iterator<std::forward_iterator_tag, Entity>
 		{
+			using Position = Hierarchy<Entity>::SubtreeIterator<Entity>;
 		public:
-			LogicalIterator(SafeIterator _itr1, const Iterator _itr2)
-				: itr1(_itr1), itr2(_itr2)
+			using Tables = std::array<const EntityTable*, NumTables>;
+
+			SubtreeIntersectionIterator(const Tables& _tables, Position _position, const ChangeFilter<NumTables>& _filter)
+				: tables(_tables), filter(_filter), position(_position)
 			{
-				Operation::FindFirst(itr1, itr2.GetCurrentItr());
+				FindMatch();
 			}
 
-			LogicalIterator& operator++()
+			SubtreeIntersectionIterator& operator++()
 			{
-				// Update the right-hand side of the iterator hierarchy.
-				++itr2;
-
-				// Intersect the result of the subtree with our left-hand SafeIterator.
-				Operation::FindNext(itr1, itr2.GetCurrentItr());
+				ASSERT(position != End(), "Iterator cannot be incremented. Check for invalid usage of With<>().");
+				++position;
+				FindMatch();
 				return *this;
 			}
 
-			LogicalIterator operator++(int)
+			SubtreeIntersectionIterator operator++(int)
 			{
-				LogicalIterator result(*this);
+				SubtreeIntersectionIterator result(*this);
 				operator++();
 				return result;
 			}
 
 			Entity& operator*() const
 			{
-				return *itr1;
+				ASSERT(position != End(), "Iterator cannot be dereferenced. Check for invalid usage of With<>().");
+				return *position;
 			}
 
 			Entity* operator->() const
 			{
-				return &(*itr1);
+				ASSERT(position != End(), "Iterator cannot be dereferenced. Check for invalid usage of With<>().");
+				return &*position;
 			}
 
-			bool operator==(const LogicalIterator& other) const
+			bool operator==(const SubtreeIntersectionIterator& other) const
 			{
-				return itr1 == other.itr1;
+				return position == other.position;
 			}
 
-			bool operator!=(const LogicalIterator& other) const
+			bool operator!=(const SubtreeIntersectionIterator& other) const
 			{
-				return itr1 != other.itr1;
+				return !operator==(other);
 			}
 
-			SafeIterator& GetCurrentItr()
+			static Position End() { return Position(nullptr, nullptr); }
+
+		private:
+			//- Advances to the next Entity of the subtree which is present in all of the tables.
+			void FindMatch()
 			{
-				return itr1;
+				for (; position != End(); ++position)
+				{
+					if (IsInAllTables(position->GetId()) && filter.Accepts(*position))
+					{
+						return;
+					}
+				}
 			}
 
+			bool IsInAllTables(u32 entityId) const
+			{
+				for (u32 i = 0; i < NumTables; ++i)
+				{
+					if (!tables[i]->Contains(entityId))
+					{
+						return false;
+					}
+				}
+
+				return true;
+			}
+
+			//- The tables being intersected.
+			Tables tables;
+			ChangeFilter<NumTables> filter;
+			//- The current position in the subtree.
+			Position position;
+		};
+
+		//- Represents a lazy-evaluated range that can be used in a range-based for loop.
+		template<class RootIterator>
+		class Range
+		{
+		public:
+			Range(RootIterator _itr, const RootIterator _itrEnd)
+				: itr(_itr), itrEnd(_itrEnd)
+			{}
+
+			RootIterator& begin() { return itr; }
+			const RootIterator& end() const { return itrEnd; }
+
 		private:
-			SafeIterator itr1;
-			Iterator itr2;
+			// The starting position of the range.
+			RootIterator itr;
+			// The ending position of the range.
+			const RootIterator itrEnd;
 		};
 
-		//- LogicalIterator specialization for the bottom of the hierarchy.
-		//- Directly operates on two SafeIterators.
-		template<class Operation>
-		class LogicalIterator<SafeIterator, Operation> : public std::iterator<std::forward_iterator_tag, Entity*>
+		//- Enumerates a dense array of Entities while performing a dereference.
+		class EntityIterator : public std::iterator<std::forward_iterator_tag, Entity>
 		{
+			using Iterator = std::vector<Entity*>::const_iterator;
 		public:
-			LogicalIterator(SafeIterator _itr1, const SafeIterator _itr2)
-				: itr1(_itr1), itr2(_itr2)
-			{
-				Operation::FindFirst(itr1, itr2);
-			}
+			EntityIterator(Iterator _itr)
+				: itr(_itr)
+			{}
 
-			LogicalIterator& operator++()
+			EntityIterator& operator++()
 			{
-				Operation::FindNext(itr1, itr2);
+				++itr;
 				return *this;
 			}
 
-			LogicalIterator operator++(int)
+			EntityIterator operator++(int)
 			{
-				LogicalIterator result(*this);
+				EntityIterator result(*this);
 				operator++();
 				return result;
 			}
 
 			Entity& operator*() const
 			{
-				return *itr1;
+				return **itr;
 			}
 
 			Entity* operator->() const
 			{
-				return &(*itr1);
-			}
-
-			bool operator==(const LogicalIterator& other) const
-			{
-				return itr1 == other.itr1 && itr2 == other.itr2;
+				return *itr;
 			}
 
-			bool operator!=(const LogicalIterator& other) const
+			bool operator==(const EntityIterator& other) const
 			{
-				return itr1 != other.itr1 || itr2 != other.itr2;
+				return itr == other.itr;
 			}
 
-			SafeIterator& GetCurrentItr()
+			bool operator!=(const EntityIterator& other) const
 			{
-				return itr1;
+				return itr != other.itr;
 			}
 
 		private:
-			SafeIterator itr1;
-			SafeIterator itr2;
+			//- The current position in the array.
+			Iterator itr;
 		};
 
-		//- Represents a lazy-evaluated range that can be used in a range-based for loop.
-		template<class RootIterator>
-		class Range
+		//- The type-erased state of a Query<>.
+		//- Registers itself in the queryIndex of its World in order to be notified as its tables in the entityIndex change.
+		class QueryBase
 		{
+			friend Entity;
 		public:
-			Range(RootIterator _itr, const RootIterator _itrEnd)
-				: itr(_itr), itrEnd(_itrEnd)
-			{}
+			QueryBase(const QueryBase&) = delete;
+			QueryBase& operator=(const QueryBase&) = delete;
 
-			RootIterator& begin() { return itr; }
-			const RootIterator& end() const { return itrEnd; }
+			//- The number of Entities currently matching the query.
+			u32 Size() const { return matches.Size(); }
+			//- Returns true if no Entities currently match the query.
+			bool IsEmpty() const { return matches.IsEmpty(); }
+
+			//- Returns true if the Entity currently matches the query.
+			bool Contains(const Entity& ent) const;
+
+		protected:
+			QueryBase(World& world, std::vector<u32> ids);
+			~QueryBase();
+
+			//- The Entities currently matching the query.
+			EntityTable matches;
 
 		private:
-			// The starting position of the range.
-			RootIterator itr;
-			// The ending position of the range.
-			const RootIterator itrEnd;
+			//- Called once one of the queried IDs has been indexed for the Entity.
+			void OnIndexed(Entity& ent);
+			//- Called once one of the queried IDs has been unindexed for the Entity.
+			void OnUnindexed(const Entity& ent);
+
+			//- Returns true if the Entity is present in each of the queried tables.
+			bool IsMatch(u32 entityId) const;
+
+			World& world;
+			//- The queried Component/Tag IDs, without duplicates.
+			std::vector<u32> ids;
+			//- The entityIndex table of each ID.
+			std::vector<const EntityTable*> tables;
 		};
 
-		//- Template deduction assisted construction.
-		template<class Iterator>
-		auto BuildLogicalIterator(SafeIterator&& set1, Iterator&& set2)
-		{
-			return LogicalIterator<Iterator, Intersection>(set1, set2);
-		}
+		//- The number of Entities processed by each task of a parallel query.
+		constexpr u32 ParallelBatchSize = 256;
 
-		//- Constructs a logical iterator representing the start of the sequence.
-		template<typename Arg1, typename Arg2, typename... Args>
-		auto BuildRootBegin()
+		//- Returns the number of tasks needed to process the specified number of Entities in parallel.
+		inline u32 GetNumBatches(u32 numEntities)
 		{
-			auto& index = entityIndex[Arg1::GetComponentId()];
-			auto rawBegin = index.begin();
-			auto rawEnd = index.end();
-
-			return BuildLogicalIterator(SafeIterator(rawBegin, rawEnd), BuildRootBegin<Arg2, Args...>());
+			return (numEntities + ParallelBatchSize - 1) / ParallelBatchSize;
 		}
 
-		//- BuildRootBegin() base case.
-		template<typename Arg>
-		SafeIterator BuildRootBegin()
+		//- Sorts the tables from smallest to largest.
+		//- Driving an intersection with the smallest table bounds the work by the rarest Component/Tag,
+		//  rather than by whichever happened to be listed first. Probing the remaining tables in ascending
+		//  order also means that candidates are most likely to be rejected by the first probe.
+		template<size_t NumTables>
+		void OrderBySize(std::array<const EntityTable*, NumTables>& tables)
 		{
-			auto& index = entityIndex[Arg::GetComponentId()];
-			auto rawBegin = index.begin();
-			auto rawEnd = index.end();
-
-			return SafeIterator(rawBegin, rawEnd);
+			std::sort(tables.begin(), tables.end(), [](const EntityTable* a, const EntityTable* b) {
+				return a->Size() < b->Size();
+			});
 		}
+	}
 
-		//- Constructs a logical iterator representing the end of the sequence.
-		template<typename Arg1, typename Arg2, typename... Args>
-		auto BuildRootEnd()
+	template<class T>
+	detail::ComponentStorage& World::GetStorage()
+	{
+		const u32 typeIndex = detail::GetStorageTypeIndex<T>();
+		if (typeIndex < storageByType.size() && storageByType[typeIndex])
 		{
-			auto rawEnd = entityIndex[Arg1::GetComponentId()].end();
-
-			return BuildLogicalIterator(SafeIterator(rawEnd, rawEnd), BuildRootEnd<Arg2, Args...>());
+			return *storageByType[typeIndex];
 		}
 
-		//- BuildRootEnd() base case.
-		template<typename Arg>
-		SafeIterator BuildRootEnd()
-		{
-			auto rawEnd = entityIndex[Arg::GetComponentId()].end();
+		return RegisterStorage(typeIndex, T::GetComponentId(), sizeof(T), alignof(T), detail::GetBaseOffset<T>());
+	}
 
-			return SafeIterator(rawEnd, rawEnd);
-		}
+	template<typename... Args>
+	auto World::GetTables() const
+	{
+		return std::array<const detail::EntityTable*, sizeof...(Args)> { &FindTable(Args::GetComponentId())... };
 	}
 
-	//- Returns an enumerable range of all enabled Components of the specified type.
-	//- This is a faster option than With<>() but it only allows you to specify a single Component type.
-	//- Additionally, by giving you the Component directly you don't have to waste time calling Entity.Get<>().
 	template<class Component>
-	auto All()
+	auto World::All()
 	{
 		static_assert(
 			std::is_base_of<ComponentBase, Component>::value,
@@ -367,23 +502,83 @@ namespace Jwl
 			"Only a direct inheritor from Component<> can be used in a query.");
 
 		using namespace detail;
-		auto& index = componentIndex[Component::GetComponentId()];
-		auto begin = ComponentIterator<Component>(index.begin());
-		auto end = ComponentIterator<Component>(index.end());
+		auto& table = FindStorages(Component::GetComponentId());
+		auto begin = ComponentIterator<Component>(table, 0);
+		auto end = ComponentIterator<Component>(table, table.size());
 
 		return detail::Range<decltype(begin)>(begin, end);
 	}
 
-	//- Returns an enumerable range of all Entities which have an active instance of each specified Component/Tag.
-	//- Disabled Components and Components belonging to disabled Entities are not considered.
-	//! Adding/Removing Components or Tags of the queried types will invalidate the returned Range.
-	//	For this reason, you must not do this until after you are finished using the Range.
 	template<typename... Args>
-	auto With()
+	auto World::With(u64 since)
 	{
 		static_assert(sizeof...(Args), 
 			"With<>() must receive at least one template argument.");
 
+		static_assert(Meta::all_of_v<std::is_base_of<ComponentBase, typename detail::QueryArg<Args>::Type>::value...>,
+			"All template arguments must be either Components or Tags.");
+
+		static_assert(Meta::all_of_v<std::is_same<typename detail::QueryArg<Args>::Type, typename detail::QueryArg<Args>::Type::StaticComponentType>::value...>,
+			"Only a direct inheritor from Component<> can be used in a query.");
+
+		using namespace detail;
+		auto tables = GetTables<typename QueryArg<Args>::Type...>();
+		OrderBySize(tables);
+
+		auto filter = MakeChangeFilter<Args...>(since);
+
+		auto begin = IntersectionIterator<sizeof...(Args)>(tables, 0, filter);
+		auto end = IntersectionIterator<sizeof...(Args)>(tables, tables[0]->Size(), filter);
+
+		return detail::Range<decltype(begin)>(begin, end);
+	}
+
+	template<class Component, class Function>
+	void World::ParallelForEach(Function&& func)
+	{
+		static_assert(
+			std::is_base_of<ComponentBase, Component>::value,
+			"Template argument must be a Component.");
+
+		static_assert(
+			!std::is_base_of<TagBase, Component>::value,
+			"Cannot query tags with ParallelForEach<>(). Use ParallelWith<>() instead.");
+
+		static_assert(
+			std::is_same<Component, typename Component::StaticComponentType>::value,
+			"Only a direct inheritor from Component<> can be used in a query.");
+
+		using namespace detail;
+		std::vector<std::pair<ComponentStorage*, u32>> chunks;
+		for (auto* storage : FindStorages(Component::GetComponentId()))
+		{
+			for (u32 chunk = 0; chunk < storage->GetNumChunks(); ++chunk)
+			{
+				chunks.emplace_back(storage, chunk);
+			}
+		}
+
+		WorkerPool.ParallelFor(chunks.size(), [&](u32 task) {
+			auto& storage = *chunks[task].first;
+			const u32 chunk = chunks[task].second;
+			const u32 size = storage.GetChunkSize(chunk);
+
+			for (u32 index = 0; index < size; ++index)
+			{
+				if (storage.IsActive(chunk, index))
+				{
+					func(*static_cast<Component*>(storage.GetComponent(chunk, index)));
+				}
+			}
+		});
+	}
+
+	template<typename... Args, class Function>
+	void World::ParallelWith(Function&& func)
+	{
+		static_assert(sizeof...(Args),
+			"ParallelWith<>() must receive at least one template argument.");
+
 		static_assert(Meta::all_of_v<std::is_base_of<ComponentBase, Args>::value...>,
 			"All template arguments must be either Components or Tags.");
 
@@ -391,18 +586,23 @@ namespace Jwl
 			"Only a direct inheritor from Component<> can be used in a query.");
 
 		using namespace detail;
-		auto begin = BuildRootBegin<Args...>();
-		auto end = BuildRootEnd<Args...>();
+		auto tables = GetTables<Args...>();
+		OrderBySize(tables);
 
-		return detail::Range<decltype(begin)>(begin, end);
+		const EntityTable& driver = *tables[0];
+		WorkerPool.ParallelFor(GetNumBatches(driver.Size()), [&](u32 batch) {
+			const u32 last = std::min<u32>((batch + 1) * ParallelBatchSize, driver.Size());
+			auto itr = IntersectionIterator<sizeof...(Args)>(tables, batch * ParallelBatchSize, last);
+
+			for (; itr.GetPosition() < last; ++itr)
+			{
+				func(*itr);
+			}
+		});
 	}
 
-	//- Returns all Entities which have an active instance of each specified Component/Tag.
-	//- Disabled Components and Components belonging to disabled Entities are not considered.
-	//- Unlike With<>(), adding or removing Components/Tags of the queried type will NOT invalidate the returned Range.
-	//! This should only be used if necessary, as it is much slower than using With<>().
 	template<typename... Args>
-	auto CaptureWith()
+	std::vector<Entity::Ptr> World::CaptureWith()
 	{
 		auto range = With<Args...>();
 
@@ -417,12 +617,155 @@ namespace Jwl
 		return result;
 	}
 
-	//- Returns the raw vector container of the specified Component.
-	//- This can be useful in special cases when you need custom iterator logic.
 	template<class Component>
-	std::vector<ComponentBase*>& GetComponentIndex()
+	const std::vector<detail::ComponentStorage*>& World::GetComponentIndex()
+	{
+		return FindStorages(Component::GetComponentId());
+	}
+
+	template<typename... Args>
+	auto Entity::With(u64 since)
 	{
+		static_assert(sizeof...(Args), 
+			"With<>() must receive at least one template argument.");
+
+		static_assert(Meta::all_of_v<std::is_base_of<ComponentBase, typename detail::QueryArg<Args>::Type>::value...>,
+			"All template arguments must be either Components or Tags.");
+
+		static_assert(Meta::all_of_v<std::is_same<typename detail::QueryArg<Args>::Type, typename detail::QueryArg<Args>::Type::StaticComponentType>::value...>,
+			"Only a direct inheritor from Component<> can be used in a query.");
+
 		using namespace detail;
-		return componentIndex[Component::GetComponentId()];
+		using Iterator = SubtreeIntersectionIterator<sizeof...(Args)>;
+
+		// Probing the smallest tables first rejects most candidates with a single lookup.
+		auto tables = world.GetTables<typename QueryArg<Args>::Type...>();
+		OrderBySize(tables);
+		auto filter = MakeChangeFilter<Args...>(since);
+
+		auto begin = Iterator(tables, GetSubtree().begin(), filter);
+		auto end = Iterator(tables, Iterator::End(), filter);
+
+		return detail::Range<decltype(begin)>(begin, end);
+	}
+
+	//- Returns an enumerable range of all enabled Components of the specified type.
+	//- This is a faster option than With<>() but it only allows you to specify a single Component type.
+	//- Additionally, by giving you the Component directly you don't have to waste time calling Entity.Get<>().
+	template<class Component>
+	auto All()
+	{
+		return World::GetDefault().All<Component>();
+	}
+
+	//- Returns an enumerable range of all Entities which have an active instance of each specified Component/Tag.
+	//- Disabled Components and Components belonging to disabled Entities are not considered.
+	//- The cost is proportional to the number of instances of the rarest specified type, regardless of argument order.
+	//- Components wrapped in Changed<> must also have changed after the 'since' change version.
+	//! Adding/Removing Components or Tags of the queried types will invalidate the returned Range.
+	//	For this reason, you must not do this until after you are finished using the Range.
+	//	Such changes can be recorded in an EntityCommandBuffer and played back afterwards.
+	template<typename... Args>
+	auto With(u64 since = 0)
+	{
+		return World::GetDefault().With<Args...>(since);
+	}
+
+	//- A persistent version of With<>() which is updated incrementally as Components and Tags are indexed.
+	//- Iterating a Query does no intersection work at all, since its matching Entities are stored densely.
+	//- This makes it ideal for systems that repeatedly run the same query, such as every frame.
+	//- Keeping a Query alive adds a small cost to adding, removing, enabling, and disabling the queried types.
+	//! Adding/Removing Components or Tags of the queried types will invalidate ongoing iterations.
+	//	For this reason, you must not do this until after you are finished iterating.
+	template<typename... Args>
+	class Query : public detail::QueryBase
+	{
+		static_assert(sizeof...(Args),
+			"Query<> must receive at least one template argument.");
+
+		static_assert(Meta::all_of_v<std::is_base_of<ComponentBase, Args>::value...>,
+			"All template arguments must be either Components or Tags.");
+
+		static_assert(Meta::all_of_v<std::is_same<Args, typename Args::StaticComponentType>::value...>,
+			"Only a direct inheritor from Component<> can be used in a query.");
+
+	public:
+		//- Matches the Entities of the specified World.
+		explicit Query(World& world = World::GetDefault())
+			: QueryBase(world, { Args::GetComponentId()... })
+		{
+		}
+
+		detail::EntityIterator begin() const { return detail::EntityIterator(matches.GetValues().begin()); }
+		detail::EntityIterator end() const { return detail::EntityIterator(matches.GetValues().end()); }
+
+		//- Invokes the function on each matching Entity, in parallel on the WorkerPool.
+		//! The same restrictions as ParallelWith<>() apply to the function.
+		template<class Function>
+		void ParallelForEach(Function&& func) const
+		{
+			using namespace detail;
+			const auto& entities = matches.GetValues();
+
+			WorkerPool.ParallelFor(GetNumBatches(entities.size()), [&](u32 batch) {
+				const u32 last = std::min<u32>((batch + 1) * ParallelBatchSize, entities.size());
+				for (u32 i = batch * ParallelBatchSize; i < last; ++i)
+				{
+					func(*entities[i]);
+				}
+			});
+		}
+	};
+
+	//- Invokes the function on all enabled Components of the specified type, in parallel on the WorkerPool.
+	//- This is the parallel counterpart of All<>(). Each chunk of the underlying storage is processed as a single task.
+	//! The function runs concurrently for different Components, so inside of it you may only:
+	//	- Read and modify the given Component, along with any data that it exclusively owns.
+	//	- Read any other Components or Entities, as long as no invocation is modifying them.
+	//	You must not add or remove Components or Tags, enable or disable anything, create or destroy Entities,
+	//	or modify the hierarchy. Gather such changes and apply them once ParallelForEach<>() returns.
+	//	Events may be sent with EventQueue.Post(), which is thread-safe, but not with Push().
+	//	Moving Entities is allowed, as long as different invocations only move Entities on separate branches of the hierarchy.
+	//	GetWorldTransform() must not be called on an Entity if another invocation might move one of its ancestors.
+	template<class Component, class Function>
+	void ParallelForEach(Function&& func)
+	{
+		World::GetDefault().ParallelForEach<Component>(std::forward<Function>(func));
+	}
+
+	//- Invokes the function on all Entities which have an active instance of each specified Component/Tag,
+	//  in parallel on the WorkerPool. This is the parallel counterpart of With<>().
+	//- The smallest table is partitioned into batches of Entities, each processed as a single task.
+	//! The function runs concurrently for different Entities, so inside of it you may only:
+	//	- Read and modify the Components of the given Entity, along with any data that they exclusively own.
+	//	- Read any other Components or Entities, as long as no invocation is modifying them.
+	//	You must not add or remove Components or Tags, enable or disable anything, create or destroy Entities,
+	//	or modify the hierarchy. Gather such changes and apply them once ParallelWith<>() returns.
+	//	Events may be sent with EventQueue.Post(), which is thread-safe, but not with Push().
+	//	Moving Entities is allowed, as long as different invocations only move Entities on separate branches of the hierarchy.
+	//	GetWorldTransform() must not be called on an Entity if another invocation might move one of its ancestors.
+	template<typename... Args, class Function>
+	void ParallelWith(Function&& func)
+	{
+		World::GetDefault().ParallelWith<Args...>(std::forward<Function>(func));
+	}
+
+	//- Returns all Entities which have an active instance of each specified Component/Tag.
+	//- Disabled Components and Components belonging to disabled Entities are not considered.
+	//- Unlike With<>(), adding or removing Components/Tags of the queried type will NOT invalidate the returned Range.
+	//! This should only be used if necessary, as it is much slower than using With<>().
+	//	Deferring the changes with an EntityCommandBuffer is usually the better option.
+	template<typename... Args>
+	auto CaptureWith()
+	{
+		return World::GetDefault().CaptureWith<Args...>();
+	}
+
+	//- Returns the raw chunked storage of the specified Component, and of any types deriving from it.
+	//- This can be useful in special cases when you need custom iterator logic.
+	template<class Component>
+	const std::vector<detail::ComponentStorage*>& GetComponentIndex()
+	{
+		return World::GetDefault().GetComponentIndex<Component>();
 	}
 }
@@ -0,0 +1,463 @@
+// Copyright (c) 2017 Emilian Cioca
+#include "Jewel3D/Precompiled.h"
+#include "Serialization.h"
+#include "Jewel3D/Application/FileSystem.h"
+#include "Jewel3D/Application/Logging.h"
+#include "Jewel3D/Utilities/ScopeGuard.h"
+
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+	//- "JWLS", identifying the data as a scene.
+	constexpr Jwl::u32 Magic = 0x534C574A;
+	constexpr Jwl::u32 Version = 1;
+
+	template<typename T>
+	void Write(std::vector<Jwl::u8>& out, const T& value)
+	{
+		const Jwl::u8* bytes = reinterpret_cast<const Jwl::u8*>(&value);
+		out.insert(out.end(), bytes, bytes + sizeof(T));
+	}
+
+	void WriteString(std::vector<Jwl::u8>& out, const std::string& str)
+	{
+		Write<Jwl::u32>(out, str.size());
+		out.insert(out.end(), str.begin(), str.end());
+	}
+
+	//- Reads values from a block of memory, failing safely if it runs out.
+	class Reader
+	{
+	public:
+		Reader(const Jwl::u8* _data, Jwl::u32 size)
+			: itr(_data), end(_data + size)
+		{}
+
+		//- Returns the next 'count' bytes, or null if there aren't enough.
+		const Jwl::u8* ReadBytes(Jwl::u32 count)
+		{
+			if (failed || static_cast<Jwl::u32>(end - itr) < count)
+			{
+				failed = true;
+				return nullptr;
+			}
+
+			const Jwl::u8* result = itr;
+			itr += count;
+			return result;
+		}
+
+		template<typename T>
+		T Read()
+		{
+			T result = T();
+			if (const Jwl::u8* bytes = ReadBytes(sizeof(T)))
+			{
+				std::memcpy(&result, bytes, sizeof(T));
+			}
+
+			return result;
+		}
+
+		std::string ReadString()
+		{
+			const Jwl::u32 length = Read<Jwl::u32>();
+			if (const Jwl::u8* bytes = ReadBytes(length))
+			{
+				return std::string(reinterpret_cast<const char*>(bytes), length);
+			}
+
+			return std::string();
+		}
+
+		//- The number of bytes left to read.
+		Jwl::u32 GetRemaining() const { return static_cast<Jwl::u32>(end - itr); }
+
+		//- Fails if 'count' records of at least 'minSize' bytes each can't fit in the remaining data.
+		//- Used to validate counts before reserving memory for them.
+		bool CanFit(Jwl::u32 count, Jwl::u32 minSize)
+		{
+			if (failed || count > GetRemaining() / minSize)
+			{
+				failed = true;
+			}
+
+			return !failed;
+		}
+
+		bool HasFailed() const { return failed; }
+
+	private:
+		const Jwl::u8* itr;
+		const Jwl::u8* end;
+		bool failed = false;
+	};
+}
+
+namespace Jwl
+{
+	namespace detail
+	{
+		//- Implements SaveScene() and LoadScene().
+		struct SceneSerializer
+		{
+			//- A type section of the scene, with its instances.
+			struct Section
+			{
+				const ComponentType* type;
+				std::vector<std::pair<u32, const ComponentBase*>> instances;
+			};
+
+			static std::vector<u8> Save(const Entity& root)
+			{
+				World& world = root.GetWorld();
+
+				std::vector<const Entity*> entities;
+				std::unordered_map<const Entity*, u32> entityIndices;
+				for (const Entity& ent : root.GetSubtree())
+				{
+					entityIndices[&ent] = entities.size();
+					entities.push_back(&ent);
+				}
+
+				// Resolve the registered type of each instance through the storage holding it, since
+				// types deriving indirectly from Component<> share the Component ID of their base.
+				auto& types = ComponentRegistry.GetTypes();
+				std::vector<Section> sections(types.size());
+				std::unordered_map<const ComponentStorage*, Section*> sectionsByStorage;
+				std::unordered_map<u32, Section*> sectionsByTag;
+				for (u32 i = 0; i < types.size(); ++i)
+				{
+					sections[i].type = types[i].get();
+					if (types[i]->isTag)
+					{
+						sectionsByTag[types[i]->componentId] = &sections[i];
+					}
+					else
+					{
+						sectionsByStorage[types[i]->GetStorage(world)] = &sections[i];
+					}
+				}
+
+				std::vector<u8> out;
+				Write(out, Magic);
+				Write(out, Version);
+				Write<u32>(out, entities.size());
+				const u32 numSectionsOffset = out.size();
+				Write<u32>(out, 0);
+
+				for (u32 i = 0; i < entities.size(); ++i)
+				{
+					const Entity& ent = *entities[i];
+					const s32 parent = i == 0 ? -1 : static_cast<s32>(entityIndices[ent.GetParentNode()]);
+
+					Write(out, parent);
+					Write<u8>(out, ent.isEnabled ? 1 : 0);
+					Write(out, ent.GetPosition());
+					Write(out, ent.GetRotation());
+					Write(out, ent.GetScale());
+
+					for (auto comp : ent.components)
+					{
+						auto itr = sectionsByStorage.find(comp->storage);
+						if (itr != sectionsByStorage.end())
+						{
+							itr->second->instances.emplace_back(i, comp);
+						}
+					}
+
+					for (u32 tag : ent.tags)
+					{
+						auto itr = sectionsByTag.find(tag);
+						if (itr != sectionsByTag.end())
+						{
+							itr->second->instances.emplace_back(i, nullptr);
+						}
+					}
+				}
+
+				u32 numSections = 0;
+				for (auto& section : sections)
+				{
+					if (section.instances.empty())
+					{
+						continue;
+					}
+
+					auto& type = *section.type;
+					WriteString(out, type.name);
+					Write<u8>(out, type.isTag ? 1 : 0);
+					Write<u32>(out, type.fields.size());
+					for (auto& field : type.fields)
+					{
+						WriteString(out, field.name);
+						Write(out, field.size);
+					}
+
+					Write<u32>(out, section.instances.size());
+					out.reserve(out.size() + section.instances.size() * (sizeof(u32) + sizeof(u8) + type.GetRecordSize()));
+
+					for (auto& instance : section.instances)
+					{
+						Write(out, instance.first);
+						Write<u8>(out, (!instance.second || instance.second->isEnabled) ? 1 : 0);
+
+						for (auto& field : type.fields)
+						{
+							if (field.size != 0)
+							{
+								field.write(*instance.second, out);
+								continue;
+							}
+
+							// Variable-sized fields are prefixed with their length.
+							const u32 lengthOffset = out.size();
+							Write<u32>(out, 0);
+							field.write(*instance.second, out);
+
+							const u32 length = out.size() - lengthOffset - sizeof(u32);
+							std::memcpy(&out[lengthOffset], &length, sizeof(u32));
+						}
+					}
+
+					numSections++;
+				}
+
+				std::memcpy(&out[numSectionsOffset], &numSections, sizeof(u32));
+
+				return out;
+			}
+
+			static Entity::Ptr Load(const u8* data, u32 size, World& world)
+			{
+				Reader reader(data, size);
+
+				if (reader.Read<u32>() != Magic)
+				{
+					Error("Scene: Data is not a valid scene.");
+					return nullptr;
+				}
+
+				const u32 version = reader.Read<u32>();
+				if (version != Version)
+				{
+					Error("Scene: Unsupported version ( %u ).", version);
+					return nullptr;
+				}
+
+				const u32 numEntities = reader.Read<u32>();
+				const u32 numSections = reader.Read<u32>();
+				// Counts are checked against the size of the data before any memory is reserved for them.
+				constexpr u32 entityRecordSize = sizeof(s32) + sizeof(u8) + sizeof(vec3) * 2 + sizeof(quat);
+				if (numEntities == 0 || !reader.CanFit(numEntities, entityRecordSize))
+				{
+					Error("Scene: Data is empty or truncated.");
+					return nullptr;
+				}
+
+				// Build the hierarchy while every Entity is disabled, so that nothing is indexed yet.
+				std::vector<Entity::Ptr> entities(numEntities);
+				std::vector<Entity*> enabledEntities;
+				enabledEntities.reserve(numEntities);
+
+				for (u32 i = 0; i < numEntities; ++i)
+				{
+					const s32 parent = reader.Read<s32>();
+					const bool isEnabled = reader.Read<u8>() != 0;
+
+					if ((i == 0) != (parent < 0) || parent >= static_cast<s32>(i))
+					{
+						Error("Scene: Entity ( %u ) has an invalid parent.", i);
+						return nullptr;
+					}
+
+					auto ent = world.CreateEntity();
+					ent->isEnabled = false;
+					Transform pose;
+					pose.position = reader.Read<vec3>();
+					pose.rotation = reader.Read<quat>();
+					pose.scale = reader.Read<vec3>();
+					ent->SetLocalTransform(pose);
+
+					if (parent >= 0)
+					{
+						entities[parent]->AddChild(ent);
+					}
+
+					if (isEnabled)
+					{
+						enabledEntities.push_back(ent.get());
+					}
+
+					entities[i] = std::move(ent);
+				}
+
+				for (u32 s = 0; s < numSections && !reader.HasFailed(); ++s)
+				{
+					if (!LoadSection(reader, entities))
+					{
+						return nullptr;
+					}
+				}
+
+				if (reader.HasFailed())
+				{
+					Error("Scene: Data is truncated.");
+					return nullptr;
+				}
+
+				// Finally, index every enabled Entity one table at a time.
+				if (!enabledEntities.empty())
+				{
+					Entity::IndexBatch(enabledEntities, true);
+
+					for (Entity* ent : enabledEntities)
+					{
+						ent->isEnabled = true;
+					}
+				}
+
+				return entities[0];
+			}
+
+			static bool LoadSection(Reader& reader, const std::vector<Entity::Ptr>& entities)
+			{
+				const std::string name = reader.ReadString();
+				const bool isTag = reader.Read<u8>() != 0;
+
+				const ComponentType* type = ComponentRegistry.Find(name);
+				if (type && type->isTag != isTag)
+				{
+					type = nullptr;
+				}
+
+				if (!type)
+				{
+					Warning("Scene: Skipping instances of unregistered type ( %s ).", name.c_str());
+				}
+
+				// Match the saved fields with the registered ones, by name and size.
+				struct SavedField
+				{
+					u32 size;
+					const ComponentField* field;
+				};
+
+				// Each field has at least the length of its name, and its size.
+				const u32 numFields = reader.Read<u32>();
+				if (!reader.CanFit(numFields, sizeof(u32) * 2))
+				{
+					Error("Scene: Data is truncated.");
+					return false;
+				}
+
+				std::vector<SavedField> fields;
+				fields.reserve(numFields);
+				for (u32 i = 0; i < numFields && !reader.HasFailed(); ++i)
+				{
+					const std::string fieldName = reader.ReadString();
+					const u32 fieldSize = reader.Read<u32>();
+
+					const ComponentField* match = nullptr;
+					if (type)
+					{
+						for (auto& field : type->fields)
+						{
+							if (field.name == fieldName && field.size == fieldSize)
+							{
+								match = &field;
+								break;
+							}
+						}
+					}
+
+					fields.push_back({ fieldSize, match });
+				}
+
+				// Each instance has at least the index of its Entity, and its enabled state.
+				const u32 numInstances = reader.Read<u32>();
+				if (!reader.CanFit(numInstances, sizeof(u32) + sizeof(u8)))
+				{
+					Error("Scene: Data is truncated.");
+					return false;
+				}
+
+				for (u32 i = 0; i < numInstances && !reader.HasFailed(); ++i)
+				{
+					const u32 entityIndex = reader.Read<u32>();
+					const bool isEnabled = reader.Read<u8>() != 0;
+					if (entityIndex >= entities.size())
+					{
+						Error("Scene: Instance of ( %s ) refers to an invalid Entity.", name.c_str());
+						return false;
+					}
+
+					ComponentBase* comp = type ? type->Create(*entities[entityIndex]) : nullptr;
+					if (comp)
+					{
+						comp->isEnabled = isEnabled;
+					}
+
+					for (auto& saved : fields)
+					{
+						const u32 length = saved.size != 0 ? saved.size : reader.Read<u32>();
+						const u8* bytes = reader.ReadBytes(length);
+
+						if (comp && saved.field && bytes)
+						{
+							saved.field->read(*comp, bytes, length);
+						}
+					}
+				}
+
+				return true;
+			}
+		};
+	}
+
+	std::vector<u8> SaveScene(const Entity& root)
+	{
+		return detail::SceneSerializer::Save(root);
+	}
+
+	bool SaveScene(const Entity& root, const std::string& filePath)
+	{
+		auto data = SaveScene(root);
+
+		FILE* file = fopen(filePath.c_str(), "wb");
+		if (file == nullptr)
+		{
+			Error("Scene: ( %s )\nUnable to open file.", filePath.c_str());
+			return false;
+		}
+		defer { fclose(file); };
+
+		if (fwrite(data.data(), sizeof(u8), data.size(), file) != data.size())
+		{
+			Error("Scene: ( %s )\nFailed to write file.", filePath.c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	Entity::Ptr LoadScene(const u8* data, u32 size, World& world)
+	{
+		return detail::SceneSerializer::Load(data, size, world);
+	}
+
+	Entity::Ptr LoadScene(const std::string& filePath, World& world)
+	{
+		MappedFile file;
+		if (!file.Open(filePath))
+		{
+			Error("Scene: ( %s )\nUnable to open file.", filePath.c_str());
+			return nullptr;
+		}
+
+		return LoadScene(file.GetData(), file.GetSize(), world);
+	}
+}
@@ -0,0 +1,29 @@
+// Copyright (c) 2017 Emilian Cioca
+#pragma once
+#include "Jewel3D/Entity/ComponentRegistry.h"
+
+#include <string>
+#include <vector>
+
+namespace Jwl
+{
+	//- Scenes are saved in a compact binary format, described by the reflection data of the ComponentRegistry.
+	//- The Entities keep their hierarchy, transforms, and enabled states. Components and Tags are saved for each registered type.
+	//  Instances of unregistered types are skipped.
+	//- The instances of each type are stored together. When all the fields of a type have a fixed size, its instances are
+	//  stored as an array of fixed-size records which are decoded by copying each field straight out of the data.
+	//- Fields are matched by name when loading, so fields that were added or removed since the scene was saved are tolerated.
+
+	//- Encodes the Entity and all of its descendants.
+	std::vector<u8> SaveScene(const Entity& root);
+
+	//- Saves the Entity and all of its descendants to a file. Returns true on success.
+	bool SaveScene(const Entity& root, const std::string& filePath);
+
+	//- Recreates an encoded scene in the World and returns its root, or null if the data is invalid.
+	//- The scene is built while disabled, then indexed one table at a time.
+	Entity::Ptr LoadScene(const u8* data, u32 size, World& world = World::GetDefault());
+
+	//- Loads a scene from a file, reading it directly from a memory-mapped view of the file.
+	Entity::Ptr LoadScene(const std::string& filePath, World& world = World::GetDefault());
+}
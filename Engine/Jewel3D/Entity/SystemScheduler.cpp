@@ -0,0 +1,168 @@
+// Copyright (c) 2017 Emilian Cioca
+#include "Jewel3D/Precompiled.h"
+#include "SystemScheduler.h"
+#include "Jewel3D/Application/Logging.h"
+#include "Jewel3D/Application/WorkerPool.h"
+
+#include <algorithm>
+
+namespace
+{
+	bool Intersects(const std::vector<Jwl::u32>& a, const std::vector<Jwl::u32>& b)
+	{
+		for (auto id : a)
+		{
+			if (std::find(b.begin(), b.end(), id) != b.end())
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+namespace Jwl
+{
+	constexpr u32 SystemAccess::TransformId;
+
+	SystemAccess& SystemAccess::ReadsTransforms()
+	{
+		reads.push_back(TransformId);
+		return *this;
+	}
+
+	SystemAccess& SystemAccess::WritesTransforms()
+	{
+		writes.push_back(TransformId);
+		return *this;
+	}
+
+	SystemAccess& SystemAccess::OnMainThread()
+	{
+		mainThread = true;
+		return *this;
+	}
+
+	SystemAccess& SystemAccess::Exclusive()
+	{
+		exclusive = true;
+		return *this;
+	}
+
+	bool SystemAccess::ConflictsWith(const SystemAccess& other) const
+	{
+		if (exclusive || other.exclusive)
+		{
+			return true;
+		}
+
+		// Any number of systems can read the same data, but a write excludes everyone else.
+		return
+			Intersects(writes, other.writes) ||
+			Intersects(writes, other.reads) ||
+			Intersects(reads, other.writes);
+	}
+
+	//-----------------------------------------------------------------------------------------------------
+
+	void SystemScheduler::Add(const std::string& name, const SystemAccess& access, Function func)
+	{
+		ASSERT(!Has(name), "A system named ( %s ) is already registered.", name.c_str());
+		ASSERT(func, "A system must have a function.");
+
+		systems.push_back({ name, access, std::move(func) });
+		isDirty = true;
+	}
+
+	void SystemScheduler::Remove(const std::string& name)
+	{
+		auto itr = std::find_if(systems.begin(), systems.end(), [&name](const System& system) {
+			return system.name == name;
+		});
+
+		if (itr != systems.end())
+		{
+			systems.erase(itr);
+			isDirty = true;
+		}
+	}
+
+	bool SystemScheduler::Has(const std::string& name) const
+	{
+		return std::find_if(systems.begin(), systems.end(), [&name](const System& system) {
+			return system.name == name;
+		}) != systems.end();
+	}
+
+	void SystemScheduler::Clear()
+	{
+		systems.clear();
+		isDirty = true;
+	}
+
+	void SystemScheduler::Run()
+	{
+		BuildStages();
+
+		for (auto& stage : stages)
+		{
+			WorkerPool.ParallelFor(stage.parallel.size(), [this, &stage](u32 i) {
+				systems[stage.parallel[i]].func();
+			});
+
+			for (u32 index : stage.mainThread)
+			{
+				systems[index].func();
+			}
+		}
+	}
+
+	u32 SystemScheduler::GetNumStages()
+	{
+		BuildStages();
+
+		return stages.size();
+	}
+
+	void SystemScheduler::BuildStages()
+	{
+		if (!isDirty)
+		{
+			return;
+		}
+
+		// Each system goes into the stage after the latest conflicting system that was added before it.
+		std::vector<u32> systemStage(systems.size());
+		stages.clear();
+
+		for (u32 i = 0; i < systems.size(); ++i)
+		{
+			u32 stage = 0;
+			for (u32 j = 0; j < i; ++j)
+			{
+				if (systems[i].access.ConflictsWith(systems[j].access))
+				{
+					stage = std::max(stage, systemStage[j] + 1);
+				}
+			}
+
+			systemStage[i] = stage;
+			if (stage >= stages.size())
+			{
+				stages.resize(stage + 1);
+			}
+
+			if (systems[i].access.IsOnMainThread())
+			{
+				stages[stage].mainThread.push_back(i);
+			}
+			else
+			{
+				stages[stage].parallel.push_back(i);
+			}
+		}
+
+		isDirty = false;
+	}
+}
@@ -0,0 +1,115 @@
+// Copyright (c) 2017 Emilian Cioca
+#pragma once
+#include "Entity.h"
+#include "Jewel3D/Utilities/Singleton.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Jwl
+{
+	//- Declares which Component and Tag types a system reads and writes.
+	//- The SystemScheduler uses this to determine which systems can safely run at the same time.
+	//  For example:
+	//	SystemAccess().Reads<Velocity>().WritesTransforms()
+	class SystemAccess
+	{
+	public:
+		//- The system reads the specified Components.
+		template<class... Components>
+		SystemAccess& Reads()
+		{
+			EXECUTE_PACK(reads.push_back(Components::GetComponentId()));
+			return *this;
+		}
+
+		//- The system modifies the specified Components.
+		template<class... Components>
+		SystemAccess& Writes()
+		{
+			EXECUTE_PACK(writes.push_back(Components::GetComponentId()));
+			return *this;
+		}
+
+		//- The system reads the transforms of Entities.
+		SystemAccess& ReadsTransforms();
+		//- The system moves Entities.
+		SystemAccess& WritesTransforms();
+
+		//- The system must run on the main thread, such as if it calls into OpenGL or OpenAL.
+		SystemAccess& OnMainThread();
+
+		//- The system changes state that can't be described by Components. For example, it adds or removes
+		//  Components, creates Entities, or modifies the hierarchy. It will never run at the same time as another system.
+		//- Sending events does not require this. EventQueue.Post() is safe from any system, only Push() must be
+		//  called from the main thread.
+		SystemAccess& Exclusive();
+
+		//- Returns true if the two systems cannot safely run at the same time.
+		bool ConflictsWith(const SystemAccess& other) const;
+
+		bool IsOnMainThread() const { return mainThread; }
+		bool IsExclusive() const { return exclusive; }
+
+	private:
+		//- Transforms are not Components, so they are represented by an ID that no Component uses.
+		static constexpr u32 TransformId = 0;
+
+		std::vector<u32> reads;
+		std::vector<u32> writes;
+		bool mainThread = false;
+		bool exclusive = false;
+	};
+
+	//- Runs a set of registered systems each update, with non-conflicting systems running in parallel.
+	//- Systems are grouped into stages. A system is placed in the stage after the last one containing a
+	//  conflicting system that was added before it. This preserves the order of any two systems that conflict.
+	//- Stages run one after another. Within a stage, the systems run concurrently on the WorkerPool, then any
+	//  systems requiring the main thread run on the calling thread.
+	//! A system running alongside others must only access the Components it has declared. Parallel
+	//	queries started from such a system run on its thread, since the workers are already busy.
+	static class SystemScheduler : public Singleton<class SystemScheduler>
+	{
+	public:
+		using Function = std::function<void()>;
+
+		//- Registers a system to be run by Run(). The name must be unique.
+		void Add(const std::string& name, const SystemAccess& access, Function func);
+		//- Unregisters the system with the specified name, if it exists.
+		void Remove(const std::string& name);
+		//- Returns true if a system is registered with the specified name.
+		bool Has(const std::string& name) const;
+		//- Unregisters all systems.
+		void Clear();
+
+		//- Runs every registered system once.
+		//! Must be called from the main thread. Systems must not be added or removed while it is running.
+		void Run();
+
+		//- Returns the number of stages that the current systems are divided into.
+		u32 GetNumStages();
+
+	private:
+		struct System
+		{
+			std::string name;
+			SystemAccess access;
+			Function func;
+		};
+
+		//- Divides the systems into stages, if they have changed since the last time.
+		void BuildStages();
+
+		std::vector<System> systems;
+
+		//- Systems which can run together, by their index in the systems array.
+		struct Stage
+		{
+			std::vector<u32> parallel;
+			std::vector<u32> mainThread;
+		};
+		std::vector<Stage> stages;
+		bool isDirty = true;
+	} &SystemScheduler = Singleton<class SystemScheduler>::instanceRef;
+}
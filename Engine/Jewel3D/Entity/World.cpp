@@ -0,0 +1,240 @@
+// Copyright (c) 2017 Emilian Cioca
+#include "Jewel3D/Precompiled.h"
+#include "World.h"
+#include "Entity.h"
+#include "Jewel3D/Application/Logging.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace
+{
+	//- Registers the World under the first free index which hasn't been retired.
+	Jwl::u32 ClaimIndex(Jwl::World& world)
+	{
+		using namespace Jwl::detail;
+
+		for (Jwl::u32 i = 0; i < MaxWorlds; ++i)
+		{
+			Jwl::World* expected = nullptr;
+			if (worlds[i].compare_exchange_strong(expected, &world))
+			{
+				// An index whose generations have run out can never be reused safely.
+				if (worldGenerations[i] > Jwl::EntityHandle::MaxGeneration)
+				{
+					worlds[i] = nullptr;
+					continue;
+				}
+
+				return i;
+			}
+		}
+
+		ASSERT(false, "Cannot have more than %u Worlds at the same time.", MaxWorlds);
+		return 0;
+	}
+}
+
+namespace Jwl
+{
+	namespace detail
+	{
+		std::atomic<World*> worlds[MaxWorlds] = {};
+		u32 worldGenerations[MaxWorlds] = {};
+
+		void EntityDeleter::operator()(Entity* ent) const
+		{
+			ent->~Entity();
+			pool->Release(ent);
+		}
+	}
+
+	constexpr u32 World::ControlBlockSize;
+	constexpr u32 World::InvalidId;
+
+	World::World()
+		: index(ClaimIndex(*this))
+		, firstGeneration(detail::worldGenerations[index] > 0 ? detail::worldGenerations[index] : 1)
+		, entityPool(sizeof(Entity), alignof(Entity))
+		, controlBlockPool(std::make_unique<detail::BlockPool>(ControlBlockSize, alignof(std::max_align_t)))
+	{
+	}
+
+	World::~World()
+	{
+		ASSERT(numEntities == 0, "World destroyed while ( %u ) of its Entities are still alive.", numEntities);
+
+		// Abandon the control blocks still referenced by weak pointers, so that releasing them later remains safe.
+		if (controlBlockPool->GetCount() > 0)
+		{
+			controlBlockPool.release();
+		}
+
+		// Every generation issued by this World is below the current generation of its slot, since slots are retired
+		// rather than wrapping around. The next World with this index starts above all of them. If that is beyond
+		// the range of a handle, the index is retired instead.
+		u32 nextGeneration = firstGeneration;
+		for (auto& slot : entitySlots)
+		{
+			nextGeneration = std::max(nextGeneration, slot.generation);
+		}
+		detail::worldGenerations[index] = nextGeneration;
+
+		// Publishes the generation along with the release of the index.
+		detail::worlds[index] = nullptr;
+	}
+
+	World& World::GetDefault()
+	{
+		// Never destroyed, since Entities kept in static storage might still be released after it.
+		static World* defaultWorld = new World();
+		return *defaultWorld;
+	}
+
+	Entity::Ptr World::CreateEntity()
+	{
+		return NewEntity(*this);
+	}
+
+	void World::UpdateWorldTransforms()
+	{
+		movedScratch.clear();
+
+		u32 id = movedEntities.exchange(InvalidId, std::memory_order_acquire);
+		while (id != InvalidId)
+		{
+			auto& slot = entitySlots[id];
+			id = slot.nextMoved;
+			slot.isMoved = false;
+
+			// The Entity might have been destroyed since, in which case there is nothing left to update.
+			if (slot.entity != nullptr)
+			{
+				movedScratch.push_back(slot.entity);
+			}
+		}
+
+		// The subtrees are refreshed from the top of the hierarchy down, so each out of date Entity is only updated once.
+		// Moved Entities below another one are already up to date by the time they are reached, and return immediately.
+		std::sort(movedScratch.begin(), movedScratch.end(), [](const Entity* a, const Entity* b) {
+			return a->GetDepth() < b->GetDepth();
+		});
+
+		for (Entity* ent : movedScratch)
+		{
+			ent->UpdateSubtreeTransforms();
+		}
+	}
+
+	u32 World::GetNumEntities() const
+	{
+		return numEntities;
+	}
+
+	World::AllocationStats World::GetAllocationStats() const
+	{
+		AllocationStats stats;
+		stats.numEntities = entityPool.GetCount();
+		stats.entityCapacity = entityPool.GetCapacity();
+		stats.totalEntityAllocations = entityPool.GetTotalAllocations();
+		stats.heapAllocations = entityPool.GetNumChunks() + controlBlockPool->GetNumChunks();
+
+		for (auto& storage : storageOwners)
+		{
+			stats.numComponents += storage->GetCount();
+			stats.componentCapacity += storage->GetNumChunks() * storage->GetChunkCapacity();
+			stats.totalComponentAllocations += storage->GetTotalAllocations();
+			stats.heapAllocations += storage->GetNumChunks();
+		}
+
+		return stats;
+	}
+
+	u32 World::GetIndex() const
+	{
+		return index;
+	}
+
+	const detail::EntityTable& World::FindTable(u32 componentId) const
+	{
+		static const detail::EntityTable emptyTable;
+
+		auto itr = entityIndex.find(componentId);
+		return itr != entityIndex.end() ? itr->second : emptyTable;
+	}
+
+	const std::vector<detail::ComponentStorage*>& World::FindStorages(u32 componentId) const
+	{
+		static const std::vector<detail::ComponentStorage*> emptyStorages;
+
+		auto itr = componentStorage.find(componentId);
+		return itr != componentStorage.end() ? itr->second : emptyStorages;
+	}
+
+	detail::ComponentStorage& World::RegisterStorage(u32 typeIndex, u32 componentId, u32 size, u32 alignment, s32 baseOffset)
+	{
+		storageOwners.push_back(std::make_unique<detail::ComponentStorage>(componentId, size, alignment, baseOffset));
+		auto& storage = *storageOwners.back();
+
+		if (typeIndex >= storageByType.size())
+		{
+			storageByType.resize(typeIndex + 1, nullptr);
+		}
+
+		storageByType[typeIndex] = &storage;
+		componentStorage[componentId].push_back(&storage);
+
+		return storage;
+	}
+
+	u32 World::AcquireId(Entity& ent)
+	{
+		u32 result;
+		if (freeEntityIds.empty())
+		{
+			result = entitySlots.size();
+			entitySlots.emplace_back();
+			entitySlots.back().generation = firstGeneration;
+		}
+		else
+		{
+			result = freeEntityIds.back();
+			freeEntityIds.pop_back();
+		}
+
+		entitySlots[result].entity = &ent;
+		numEntities++;
+
+		return result;
+	}
+
+	void World::ReleaseId(u32 id)
+	{
+		// Invalidate all handles to this Entity.
+		auto& slot = entitySlots[id];
+		slot.entity = nullptr;
+		numEntities--;
+
+		// Once its generations run out, the ID is retired. Wrapping around would allow old handles to resolve again.
+		if (++slot.generation <= EntityHandle::MaxGeneration)
+		{
+			freeEntityIds.push_back(id);
+		}
+	}
+
+	void World::QueueMoved(u32 id)
+	{
+		auto& slot = entitySlots[id];
+		if (slot.isMoved)
+		{
+			return;
+		}
+
+		slot.isMoved = true;
+		slot.nextMoved = movedEntities.load(std::memory_order_relaxed);
+		while (!movedEntities.compare_exchange_weak(slot.nextMoved, id, std::memory_order_release, std::memory_order_relaxed))
+		{
+			// Another thread queued an Entity first. 'slot.nextMoved' now holds the new top of the stack, so try again.
+		}
+	}
+}
@@ -0,0 +1,199 @@
+// Copyright (c) 2017 Emilian Cioca
+#pragma once
+#include "Jewel3D/Application/Types.h"
+#include "Jewel3D/Entity/BlockPool.h"
+#include "Jewel3D/Entity/ComponentStorage.h"
+#include "Jewel3D/Utilities/SparseSet.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Jwl
+{
+	class Entity;
+	class EntityHandle;
+	class Name;
+	class World;
+
+	namespace detail
+	{
+		class QueryBase;
+
+		using EntityTable = SparseSet<Entity*>;
+
+		//- An entry of the entitySlots table of a World.
+		struct EntitySlot
+		{
+			//- The living Entity using this ID, if any.
+			Entity* entity = nullptr;
+			//- Incremented each time the ID is released, invalidating any handles to the previous Entity.
+			//- The ID is never reused after it passes EntityHandle::MaxGeneration.
+			u32 generation = 1;
+
+			//- Links the IDs of the Entities that moved since the last call to UpdateWorldTransforms().
+			u32 nextMoved = 0;
+			bool isMoved = false;
+		};
+
+		//- Destroys an Entity and returns its memory to the pool that it came from.
+		struct EntityDeleter
+		{
+			void operator()(Entity* ent) const;
+
+			BlockPool* pool;
+		};
+
+		//- The maximum number of Worlds that can exist at the same time.
+		constexpr u32 MaxWorlds = 256;
+
+		//- Every living World, by its index. Used to resolve EntityHandles.
+		extern std::atomic<World*> worlds[MaxWorlds];
+
+		//- The generation that Entity IDs start at in the next World to claim each index.
+		//- Each World continues from the generations issued by the previous World with its index,
+		//  so handles to the Entities of a destroyed World never resolve to the Entities of the next one.
+		//- An index is retired once this passes EntityHandle::MaxGeneration.
+		extern u32 worldGenerations[MaxWorlds];
+	}
+
+	//- An independent collection of Entities, along with the index tables that power the queries.
+	//- Entities belong to the World they were created in for their entire lifetime, and queries on a World
+	//  only see its own Entities. Worlds share no mutable state, so separate Worlds can be used from
+	//  separate threads at the same time. For example, to simulate many independent matches in one process.
+	//- Entity::MakeNew() and the free query functions, such as All<>() and With<>(), use the default World.
+	//- Entities, their shared control blocks, and their Components are all allocated from pools owned by the World.
+	//  Once the pools have grown to fit the peak number of Entities, creating and destroying them is free of heap allocations.
+	//! A World must outlive its Entities and Query<>s. Each World must only be used by one thread at a time.
+	class World
+	{
+		friend Entity;
+		friend EntityHandle;
+		friend detail::QueryBase;
+		friend Name;
+		friend class Prefab;
+	public:
+		World();
+		World(const World&) = delete;
+		World& operator=(const World&) = delete;
+		~World();
+
+		//- Returns the World used by Entity::MakeNew() and the free query functions.
+		//- It exists for the duration of the program.
+		static World& GetDefault();
+
+		//- Creates and returns a new Entity belonging to this World.
+		std::shared_ptr<Entity> CreateEntity();
+
+		//- These match the free functions of the same name, but only consider the Entities of this World.
+		template<class Component>
+		auto All();
+		template<typename... Args>
+		auto With(u64 since = 0);
+		template<class Component, class Function>
+		void ParallelForEach(Function&& func);
+		template<typename... Args, class Function>
+		void ParallelWith(Function&& func);
+		template<typename... Args>
+		std::vector<std::shared_ptr<Entity>> CaptureWith();
+		template<class Component>
+		const std::vector<detail::ComponentStorage*>& GetComponentIndex();
+
+		//- Refreshes the cached world transform of every Entity that moved in this World, along with their descendants.
+		void UpdateWorldTransforms();
+
+		//- The number of living Entities.
+		u32 GetNumEntities() const;
+
+		//- Describes the memory used by the Entities and Components of a World. Useful for profiling.
+		struct AllocationStats
+		{
+			//- Entities and Components currently alive.
+			u32 numEntities = 0;
+			u32 numComponents = 0;
+			//- The number of Entities and Components that can be alive before more memory is needed.
+			u32 entityCapacity = 0;
+			u32 componentCapacity = 0;
+			//- The number of Entities and Components created over the lifetime of the World.
+			u64 totalEntityAllocations = 0;
+			u64 totalComponentAllocations = 0;
+			//- The number of times that the pools had to request memory from the heap.
+			u32 heapAllocations = 0;
+		};
+
+		AllocationStats GetAllocationStats() const;
+
+		//- The index of the World among all living Worlds. It is encoded in the handles of its Entities.
+		u32 GetIndex() const;
+
+		//- Returns the storage dedicated to the concrete type T, creating it on first use. Used internally.
+		template<class T>
+		detail::ComponentStorage& GetStorage();
+
+	private:
+		//- Constructs an Entity in pooled memory.
+		template<typename... Args>
+		std::shared_ptr<Entity> NewEntity(Args&&... params);
+
+		//- Gathers the entityIndex tables of each of the specified Components/Tags.
+		template<typename... Args>
+		auto GetTables() const;
+
+		//- Lookups for the read-only query paths. A type which was never added yields an empty table rather than
+		//  inserting one, so that queries running concurrently on worker threads never modify the maps.
+		const detail::EntityTable& FindTable(u32 componentId) const;
+		const std::vector<detail::ComponentStorage*>& FindStorages(u32 componentId) const;
+
+		//- Creates and registers the storage for a new concrete Component type.
+		detail::ComponentStorage& RegisterStorage(u32 typeIndex, u32 componentId, u32 size, u32 alignment, s32 baseOffset);
+
+		u32 AcquireId(Entity& ent);
+		void ReleaseId(u32 id);
+
+		//- Records that the Entity has moved, so that UpdateWorldTransforms() refreshes its subtree.
+		//- Queueing is thread-safe. See Entity::GetLocalTransform() for the rules on moving Entities from parallel queries.
+		void QueueMoved(u32 id);
+
+		const u32 index;
+		//- The generation of newly created Entity IDs.
+		const u32 firstGeneration;
+
+		//- Index of all Entities for each component and tag type. Used to power the queries.
+		//- Each table is a sparse set keyed by Entity ID, allowing constant-time membership tests between tables.
+		std::unordered_map<u32, detail::EntityTable> entityIndex;
+
+		//- Every ComponentStorage, by the Component ID that they are queried under.
+		//- Types deriving indirectly from Component<> share the ID of their base, and thus its table.
+		std::unordered_map<u32, std::vector<detail::ComponentStorage*>> componentStorage;
+		//- Every ComponentStorage, by the storage type index of its concrete type.
+		std::vector<detail::ComponentStorage*> storageByType;
+		std::vector<std::unique_ptr<detail::ComponentStorage>> storageOwners;
+
+		//- Every live Query<>, by each Component/Tag ID that it depends on.
+		std::unordered_map<u32, std::vector<detail::QueryBase*>> queryIndex;
+
+		//- Maps each Entity ID to the Entity currently using it. Used to resolve EntityHandles.
+		std::vector<detail::EntitySlot> entitySlots;
+		//- IDs released by destroyed Entities, waiting to be reused.
+		std::vector<u32> freeEntityIds;
+		u32 numEntities = 0;
+
+		//- The most recently moved Entity, forming a lock-free stack through the entitySlots table with the ones moved before it.
+		std::atomic<u32> movedEntities{ InvalidId };
+		static constexpr u32 InvalidId = ~0u;
+		//- The moved Entities being refreshed by UpdateWorldTransforms(). Kept between calls to reuse its memory.
+		std::vector<Entity*> movedScratch;
+
+		//- Every Name Component, by the interned string of its name. Used to power FindEntity() and FindChild().
+		std::unordered_map<const std::string*, std::vector<Name*>> nameIndex;
+
+		//- The size, in bytes, reserved for the shared control block of each Entity::Ptr.
+		static constexpr u32 ControlBlockSize = 64;
+
+		detail::BlockPool entityPool;
+		//- Separate from the World, since weak references can keep control blocks alive longer than their Entities.
+		std::unique_ptr<detail::BlockPool> controlBlockPool;
+	};
+}
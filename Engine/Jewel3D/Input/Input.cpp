@@ -76,7 +76,7 @@ namespace Jwl
 				y = -(static_cast<s32>(GET_Y_LPARAM(msg.lParam)) - Application.GetScreenHeight());
 				vec2 pos(static_cast<f32>(x), static_cast<f32>(y));
 
-				EventQueue.Push(std::make_unique<MouseMoved>(pos, pos - lastPos));
+				EventQueue.Push<MouseMoved>(pos, pos - lastPos);
 				break;
 			}
 
@@ -88,7 +88,7 @@ namespace Jwl
 
 				// We only distribute the event if the previous key-state was KeyUp.
 				keys[key] = true;
-				EventQueue.Push(std::make_unique<KeyPressed>(static_cast<Key>(key)));
+				EventQueue.Push<KeyPressed>(static_cast<Key>(key));
 			}
 			break;
 
@@ -97,42 +97,42 @@ namespace Jwl
 				auto key = MapLeftRightKeys(msg.wParam, msg.lParam);
 
 				keys[key] = false;
-				EventQueue.Push(std::make_unique<KeyReleased>(static_cast<Key>(key)));
+				EventQueue.Push<KeyReleased>(static_cast<Key>(key));
 				break;
 			}
 
 		case WM_LBUTTONDOWN:
 			keys[static_cast<u32>(Key::MouseLeft)] = true;
-			EventQueue.Push(std::make_unique<KeyPressed>(Key::MouseLeft));
+			EventQueue.Push<KeyPressed>(Key::MouseLeft);
 			break;
 
 		case WM_LBUTTONUP:
 			keys[static_cast<u32>(Key::MouseLeft)] = false;
-			EventQueue.Push(std::make_unique<KeyReleased>(Key::MouseLeft));
+			EventQueue.Push<KeyReleased>(Key::MouseLeft);
 			break;
 
 		case WM_RBUTTONDOWN:
 			keys[static_cast<u32>(Key::MouseRight)] = true;
-			EventQueue.Push(std::make_unique<KeyPressed>(Key::MouseRight));
+			EventQueue.Push<KeyPressed>(Key::MouseRight);
 			break;
 
 		case WM_RBUTTONUP:
 			keys[static_cast<u32>(Key::MouseRight)] = false;
-			EventQueue.Push(std::make_unique<KeyReleased>(Key::MouseRight));
+			EventQueue.Push<KeyReleased>(Key::MouseRight);
 			break;
 
 		case WM_MBUTTONDOWN:
 			keys[static_cast<u32>(Key::MouseMiddle)] = true;
-			EventQueue.Push(std::make_unique<KeyPressed>(Key::MouseMiddle));
+			EventQueue.Push<KeyPressed>(Key::MouseMiddle);
 			break;
 
 		case WM_MBUTTONUP:
 			keys[static_cast<u32>(Key::MouseMiddle)] = false;
-			EventQueue.Push(std::make_unique<KeyReleased>(Key::MouseMiddle));
+			EventQueue.Push<KeyReleased>(Key::MouseMiddle);
 			break;
 
 		case WM_MOUSEWHEEL:
-			EventQueue.Push(std::make_unique<MouseScrolled>(static_cast<s32>(GET_WHEEL_DELTA_WPARAM(msg.wParam) / WHEEL_DELTA)));
+			EventQueue.Push<MouseScrolled>(static_cast<s32>(GET_WHEEL_DELTA_WPARAM(msg.wParam) / WHEEL_DELTA));
 			break;
 
 		default:
@@ -64,13 +64,24 @@ namespace Jwl
 		position.Set(other.position.Get());
 		direction.Set(other.direction.Get());
 
+		// The copied buffer was computed from the other light's transform.
+		updateVersion = 0;
+
 		return *this;
 	}
 
 	void Light::Update()
 	{
-		auto transform = owner.GetWorldTransform();
-		
+		auto& transform = owner.GetWorldTransform();
+
+		if (updateVersion != 0 &&
+			owner.GetWorldTransformVersion() <= updateVersion &&
+			type == updateType &&
+			angle == updateAngle)
+		{
+			return;
+		}
+
 		switch (type)
 		{
 		case Type::Spot:
@@ -88,6 +99,11 @@ namespace Jwl
 			position.Set(vec3(0.0f));
 			break;
 		}
+
+		MarkChanged();
+		updateVersion = GetChangeVersion();
+		updateType = type;
+		updateAngle = angle;
 	}
 
 	UniformBuffer::Ptr& Light::GetBuffer()
@@ -35,6 +35,8 @@ namespace Jwl
 		f32 angle = 25.0f;
 
 		//- Keeps the internal buffer up to date with the light's transform.
+		//- This is skipped if the light hasn't moved or been reconfigured since the last update.
+		//  Otherwise, the light is flagged as changed.
 		void Update();
 
 		UniformBuffer::Ptr& GetBuffer();
@@ -47,5 +49,10 @@ namespace Jwl
 		UniformHandle<vec3> direction;
 		UniformHandle<f32> cosAngle;
 		UniformBuffer::Ptr lightBuffer;
+
+		//- The state from which the buffer was last updated.
+		u64 updateVersion = 0;
+		Type updateType = Type::Point;
+		f32 updateAngle = 0.0f;
 	};
 }
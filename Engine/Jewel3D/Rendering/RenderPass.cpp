@@ -191,7 +191,10 @@ namespace Jwl
 	{
 		Bind();
 
-		RenderEntityRecursive(root);
+		for (auto& ent : root.GetSubtree())
+		{
+			RenderEntity(ent);
+		}
 
 		if (skybox)
 		{
@@ -306,18 +309,25 @@ namespace Jwl
 
 			const vec3 advanceDirection = text->owner.GetWorldTransform().GetRight();
 			const vec3 upDirection = text->owner.GetWorldTransform().GetUp();
-			const vec3 initialPosition = text->owner.position;
-			vec3 linePosition = text->owner.position;
+			const vec3 initialPosition = text->owner.GetPosition();
+			vec3 linePosition = initialPosition;
+
+			// Each glyph is drawn with the Entity's transform, offset to the pen's position in the parent's space.
+			// The Entity itself is left in place, so drawing text doesn't mark it or its children as moved.
+			const Entity* parent = text->owner.GetParentNode();
+			const mat4 parentTransform = parent ? parent->GetWorldTransform() : mat4::Identity;
+			mat4 glyphTransform = text->owner.GetWorldTransform();
+			vec3 penPosition = initialPosition;
 			u32 currentLine = 1;
 
 			if (text->centeredX)
 			{
-				text->owner.position -= advanceDirection * (((text->GetLineWidth(currentLine) + text->kernel * text->text.size())) / 2.0f);
+				penPosition -= advanceDirection * (((text->GetLineWidth(currentLine) + text->kernel * text->text.size())) / 2.0f);
 			}
 
 			if (text->centeredY)
 			{
-				text->owner.position -= upDirection * ((font->GetStringHeight() * static_cast<f32>(text->GetNumLines())) / 2.0f);
+				penPosition -= upDirection * ((font->GetStringHeight() * static_cast<f32>(text->GetNumLines())) / 2.0f);
 			}
 
 			glBindVertexArray(Font::GetVAO());
@@ -331,32 +341,32 @@ namespace Jwl
 				// Handle whitespace.
 				if (character == ' ')
 				{
-					text->owner.position += advanceDirection * (font->GetStringWidth("Z") + text->kernel);
+					penPosition += advanceDirection * (font->GetStringWidth("Z") + text->kernel);
 					continue;
 				}
 				else if (character == '\n')
 				{
 					linePosition += -upDirection * static_cast<f32>(font->GetStringHeight()) * 1.33f;
-					text->owner.position = linePosition;
+					penPosition = linePosition;
 					currentLine++;
 
 					if (text->centeredX)
 					{
-						text->owner.position -= advanceDirection * (((text->GetLineWidth(currentLine) + text->kernel * text->text.size())) / 2.0f);
+						penPosition -= advanceDirection * (((text->GetLineWidth(currentLine) + text->kernel * text->text.size())) / 2.0f);
 					}
 
 					continue;
 				}
 				else if (character == '\t')
 				{
-					text->owner.position += advanceDirection * (font->GetStringWidth("Z") + text->kernel) * 4;
+					penPosition += advanceDirection * (font->GetStringWidth("Z") + text->kernel) * 4;
 					continue;
 				}
 
 				if (!masks[charIndex])
 				{
 					// Character does not exist in this font. Advance to next character.
-					text->owner.position += advanceDirection * ((advances[charIndex].x + text->kernel));
+					penPosition += advanceDirection * ((advances[charIndex].x + text->kernel));
 					continue;
 				}
 
@@ -364,7 +374,10 @@ namespace Jwl
 				vec3 characterPosition;
 				characterPosition += advanceDirection * static_cast<f32>(positions[charIndex].x);
 				characterPosition += upDirection * static_cast<f32>(positions[charIndex].y);
-				text->owner.position += characterPosition;
+				penPosition += characterPosition;
+
+				const vec4 glyphPosition = parentTransform * vec4(penPosition, 1.0f);
+				glyphTransform.SetTranslation(vec3(glyphPosition.x, glyphPosition.y, glyphPosition.z));
 
 				/* Construct a polygon based on the current character's dimensions. */
 				points[3] = static_cast<f32>(dimensions[charIndex].x);
@@ -383,16 +396,16 @@ namespace Jwl
 				{
 					auto& cameraComponent = camera->Get<Camera>();
 
-					MVP.Set(cameraComponent.GetViewProjMatrix() * text->owner.GetWorldTransform());
-					modelView.Set(cameraComponent.GetViewMatrix() * text->owner.GetWorldTransform());
+					MVP.Set(cameraComponent.GetViewProjMatrix() * glyphTransform);
+					modelView.Set(cameraComponent.GetViewMatrix() * glyphTransform);
 				}
 				else
 				{
 					MVP.Set(mat4::Identity);
 					modelView.Set(mat4::Identity);
 				}
-				model.Set(text->owner.GetWorldTransform());
-				invModel.Set(text->owner.GetWorldTransform().GetFastInverse());
+				model.Set(glyphTransform);
+				invModel.Set(glyphTransform.GetFastInverse());
 				transformBuffer.Bind(static_cast<u32>(UniformBufferSlot::Model));
 
 				glBindTexture(GL_TEXTURE_2D, font->GetTextures()[charIndex]);
@@ -400,14 +413,12 @@ namespace Jwl
 
 				/* Adjust position for the next node. */
 				// Undo character translate.
-				text->owner.position -= characterPosition;
+				penPosition -= characterPosition;
 				// Advance to next character.
-				text->owner.position += advanceDirection * ((advances[charIndex].x + text->kernel));
+				penPosition += advanceDirection * ((advances[charIndex].x + text->kernel));
 			}
 
 			glBindBuffer(GL_ARRAY_BUFFER, GL_NONE);
-
-			text->owner.position = initialPosition;
 		}
 #pragma endregion
 
@@ -433,16 +444,6 @@ namespace Jwl
 		material->UnBind();
 	}
 
-	void RenderPass::RenderEntityRecursive(const Entity& ent)
-	{
-		RenderEntity(ent);
-
-		for (auto& child : ent.GetChildren())
-		{
-			RenderEntityRecursive(*child);
-		}
-	}
-
 	void RenderPass::CreateUniformBuffer()
 	{
 		transformBuffer.AddUniform("MVP", sizeof(mat4));
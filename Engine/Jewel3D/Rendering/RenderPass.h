@@ -54,7 +54,6 @@ namespace Jwl
 		void UnBind();
 
 		void RenderEntity(const Entity& ent);
-		void RenderEntityRecursive(const Entity& ent);
 
 		void CreateUniformBuffer();
 		void CreateUniformHandles();
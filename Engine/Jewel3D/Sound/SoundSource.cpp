@@ -80,6 +80,9 @@ namespace Jwl
 
 		alSourcePlay(hSound);
 		AL_DEBUG_CHECK();
+
+		// Ensures that the SoundSystem syncs the position of the sound.
+		MarkChanged();
 	}
 
 	void SoundSource::Stop()
@@ -98,6 +101,9 @@ namespace Jwl
 	{
 		alSourcePlay(hSound);
 		AL_DEBUG_CHECK();
+
+		// Ensures that the SoundSystem syncs the position of the sound.
+		MarkChanged();
 	}
 
 	bool SoundSource::IsPlaying() const
@@ -138,12 +138,20 @@ namespace Jwl
 		AL_DEBUG_CHECK();
 
 		/* Update all sounds */
+		// Only sources that have moved, or have started playing, since the last update need a new position.
+		const u64 previousVersion = updateVersion;
+		updateVersion = GetLatestChangeVersion();
+
 		for (auto& source : All<SoundSource>())
 		{
+			const mat4& transform = source.owner.GetWorldTransform();
+			if (source.owner.GetWorldTransformVersion() <= previousVersion && !source.HasChangedSince(previousVersion))
+				continue;
+
 			if (!source.IsPlaying())
 				continue;
 
-			vec3 position = source.owner.GetWorldTransform().GetTranslation();
+			vec3 position = transform.GetTranslation();
 
 			pos[0] = position.x;
 			pos[1] = position.y;
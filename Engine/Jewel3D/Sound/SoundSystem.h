@@ -36,5 +36,8 @@ namespace Jwl
 	private:
 		ALCdevice_struct* device = nullptr;
 		ALCcontext_struct* context = nullptr;
+
+		//- The change version at the time of the previous Update().
+		u64 updateVersion = 0;
 	} &SoundSystem = Singleton<class SoundSystem>::instanceRef;
 }
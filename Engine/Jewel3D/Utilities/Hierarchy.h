@@ -2,6 +2,7 @@
 #pragma once
 #include "Jewel3D/Resource/Shareable.h"
 
+#include <iterator>
 #include <vector>
 
 namespace Jwl
@@ -10,17 +11,60 @@ namespace Jwl
 	//- All nodes are managed by smart pointers.
 	//- Derive from this to create a hierarchical type. Your class should pass itself as the template:
 	//	class NodeData : public Hierarchy<NodeData> { /* */ };
+	//- Each node caches raw links to its parent and root, its depth, and its position among its siblings.
+	//  These are refreshed whenever the node's branch is moved, which keeps queries like GetRoot() and GetDepth()
+	//  constant-time, and allows the subtree to be traversed without recursion or extra memory.
 	template<class Node>
 	class Hierarchy : public Shareable<Node>
 	{
 	public:
+		//- Enumerates a subtree in depth-first order, visiting each node before its children.
+		//- Traversal does not recurse or allocate memory, so it is safe on hierarchies of any depth.
+		//! The hierarchy must not be modified while it is being traversed.
+		template<class Element>
+		class SubtreeIterator : public std::iterator<std::forward_iterator_tag, Element>
+		{
+		public:
+			SubtreeIterator(Element* current, const Node* root);
+
+			SubtreeIterator& operator++();
+			SubtreeIterator operator++(int);
+
+			Element& operator*() const { return *current; }
+			Element* operator->() const { return current; }
+
+			bool operator==(const SubtreeIterator& other) const { return current == other.current; }
+			bool operator!=(const SubtreeIterator& other) const { return current != other.current; }
+
+		private:
+			Element* current;
+			//- The node that the traversal started from.
+			const Node* root;
+		};
+
+		template<class Element>
+		class SubtreeRange
+		{
+		public:
+			SubtreeRange(Element& root)
+				: root(&root)
+			{}
+
+			SubtreeIterator<Element> begin() const { return SubtreeIterator<Element>(root, root); }
+			SubtreeIterator<Element> end() const { return SubtreeIterator<Element>(nullptr, root); }
+
+		private:
+			Element* root;
+		};
+
 		Hierarchy& operator=(const Hierarchy&);
 		~Hierarchy();
 
-		//- Appends a child to this node.
+		//- Appends a child to this node. If the child already has a different parent, it is moved here.
 		void AddChild(Ptr child);
 
-		//- Removes the child from the hierarchy,
+		//- Removes the child from the hierarchy. This is done in constant time by moving
+		//  the last child into the vacated position, so the order of the remaining children can change.
 		void RemoveChild(Node& child);
 
 		//- Returns true if the specifed node is a child of this one.
@@ -38,12 +82,26 @@ namespace Jwl
 		//- Returns this node's parent, if it has one.
 		Ptr GetParent() const;
 
+		//- Returns this node's parent, if it has one, without acquiring ownership of it.
+		//- Cheaper than GetParent() when the parent is only being inspected.
+		Node* GetParentNode() const;
+
 		//- Returns the number of children currently held by this node.
 		u32 GetNumChildren() const;
 
 		//- Gets the list of children held by this node.
 		const auto& GetChildren() const { return children; }
 
+		//- Returns this node followed by all of its descendants, in depth-first order.
+		SubtreeRange<Node> GetSubtree();
+		SubtreeRange<const Node> GetSubtree() const;
+
+		//- Calls 'visit' on this node and its descendants in depth-first order, visiting each node before its children.
+		//- The descendants of a node are skipped if 'visit' returns false for it. Like GetSubtree(), this does not recurse.
+		//! The hierarchy must not be modified during the traversal.
+		template<class Function>
+		void VisitSubtree(Function&& visit);
+
 		//- Gets the depth of this node in the hierarchy. The root is always depth 0.
 		//	Direct children of the root are at depth 1, and so on.
 		u32 GetDepth() const;
@@ -54,9 +112,48 @@ namespace Jwl
 		//- Returns true if this node doesn't have any children.
 		bool IsLeaf() const;
 
+		//- Returns a number which changes whenever a node is added to or removed from the subtree, or MarkSubtreeChanged()
+		//  is called on a node in the subtree, after the subtree was last cleared with ClearSubtreeChanged().
+		//  Caches derived from the subtree can compare this to see if they are out of date.
+		u32 GetSubtreeVersion() const;
+
+		//- Updates the subtree version of this node and all of its ancestors.
+		//- Call this when data which is cached per subtree changes, such as the components of interest to an EventDispatcher.
+		//- Nodes stay marked until ClearSubtreeChanged() is called on them. The walk stops at the first marked ancestor,
+		//  since its version has already changed, so building a hierarchy costs constant time per edit.
+		void MarkSubtreeChanged();
+
+		//- Unmarks the subtree, so that the next change inside of it updates the versions again.
+		//- Caches derived from the subtree should call this after recording its version.
+		//- Only marked nodes are visited, so the cost is proportional to the part of the subtree that changed.
+		void ClearSubtreeChanged();
+
+	protected:
+		//- Called on a node after it is attached to, or detached from, a parent.
+		//- Derived classes can hide this with their own version to respond to being moved.
+		void OnParentChanged() {}
+
 	private:
+		//- Refreshes the cached depth and root of this node and all of its descendants, after the node was moved.
+		void RefreshSubtree();
+
+		Node* GetRootNode() const;
+
 		WeakPtr parent;
 		std::vector<Ptr> children;
+
+		//- Cached links, kept up to date whenever the branch is moved.
+		Node* parentNode = nullptr;
+		//- Null when this node is the root.
+		Node* rootNode = nullptr;
+		u32 depth = 0;
+		//- The position of this node in its parent's list of children.
+		u32 childIndex = 0;
+
+		u32 subtreeVersion = 0;
+		//- Set when the subtree version changes, until the subtree is cleared.
+		//- The ancestors of a marked node are always marked as well.
+		bool isSubtreeMarked = false;
 	};
 }
 
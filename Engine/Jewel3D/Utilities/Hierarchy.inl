@@ -1,20 +1,65 @@
 // Copyright (c) 2017 Emilian Cioca
 namespace Jwl
 {
+	template<class Node> template<class Element>
+	Hierarchy<Node>::SubtreeIterator<Element>::SubtreeIterator(Element* _current, const Node* _root)
+		: current(_current)
+		, root(_root)
+	{
+	}
+
+	template<class Node> template<class Element>
+	typename Hierarchy<Node>::template SubtreeIterator<Element>& Hierarchy<Node>::SubtreeIterator<Element>::operator++()
+	{
+		const Hierarchy* node = current;
+
+		// Descend into the first child.
+		if (!node->children.empty())
+		{
+			current = node->children.front().get();
+			return *this;
+		}
+
+		// Otherwise, climb until there is a next sibling, without leaving the subtree.
+		while (node != root)
+		{
+			const Hierarchy* parentNode = node->parentNode;
+			const u32 next = node->childIndex + 1;
+			if (next < parentNode->children.size())
+			{
+				current = parentNode->children[next].get();
+				return *this;
+			}
+
+			node = parentNode;
+		}
+
+		current = nullptr;
+		return *this;
+	}
+
+	template<class Node> template<class Element>
+	typename Hierarchy<Node>::template SubtreeIterator<Element> Hierarchy<Node>::SubtreeIterator<Element>::operator++(int)
+	{
+		SubtreeIterator result(*this);
+		operator++();
+		return result;
+	}
+
 	template<class Node>
 	Hierarchy<Node>& Hierarchy<Node>::operator=(const Hierarchy& other)
 	{
-		if (auto lock = other.parent.lock())
+		ClearChildren();
+
+		if (other.parentNode)
 		{
-			lock->AddChild(GetPtr());
+			other.parentNode->AddChild(GetPtr());
 		}
-		else
+		else if (parentNode)
 		{
-			parent.reset();
+			parentNode->RemoveChild(*static_cast<Node*>(this));
 		}
 
-		children.clear();
-
 		return *this;
 	}
 
@@ -36,71 +81,107 @@ namespace Jwl
 		ASSERT(this != child.get(), "Hierarchy cannot add itself as a child.");
 
 		// Check if this node is already our child.
-		if (!IsChild(*child))
+		if (IsChild(*child))
+		{
+			return;
+		}
+
+		if (child->parentNode)
 		{
-			child->parent = GetWeakPtr();
-			children.push_back(child);
+			child->parentNode->RemoveChild(*child);
 		}
+
+		child->parent = GetWeakPtr();
+		child->parentNode = static_cast<Node*>(this);
+		child->childIndex = children.size();
+		children.push_back(child);
+
+		child->RefreshSubtree();
+		MarkSubtreeChanged();
 	}
 
 	template<class Node>
 	void Hierarchy<Node>::RemoveChild(Node& child)
 	{
-		for (unsigned i = 0; i < children.size(); i++)
+		if (!IsChild(child))
 		{
-			if (children[i].get() == &child)
-			{
-				child.parent.reset();
-				children.erase(children.begin() + i);
+			return;
+		}
 
-				return;
-			}
+		// Keep the child alive until its links are reset.
+		const u32 index = child.childIndex;
+		Ptr removed = std::move(children[index]);
+
+		if (index != children.size() - 1)
+		{
+			children[index] = std::move(children.back());
+			children[index]->childIndex = index;
 		}
+		children.pop_back();
+
+		child.parent.reset();
+		child.parentNode = nullptr;
+		child.childIndex = 0;
+		child.RefreshSubtree();
+
+		MarkSubtreeChanged();
 	}
 
 	template<class Node>
 	bool Hierarchy<Node>::IsChild(const Node& node) const
 	{
-		return 
-			!node.parent.expired() && 
-			node.parent.lock().get() == static_cast<const Node*>(this);
+		return node.parentNode == static_cast<const Node*>(this);
 	}
 
 	template<class Node>
 	void Hierarchy<Node>::ClearChildren()
 	{
-		for (auto child : children)
+		if (children.empty())
 		{
-			child->parent.reset();
+			return;
 		}
 
+		std::vector<Ptr> pending = std::move(children);
 		children.clear();
+		MarkSubtreeChanged();
+
+		while (!pending.empty())
+		{
+			Ptr child = std::move(pending.back());
+			pending.pop_back();
+
+			child->parent.reset();
+			child->parentNode = nullptr;
+			child->childIndex = 0;
+
+			if (child.use_count() == 1)
+			{
+				// The child is released below. Its own children are released here as well, rather than
+				// recursively from its destructor, so that deep branches cannot overflow the stack.
+				for (auto& grandChild : child->children)
+				{
+					pending.push_back(std::move(grandChild));
+				}
+
+				child->children.clear();
+			}
+			else
+			{
+				child->RefreshSubtree();
+			}
+		}
 	}
 
 	template<class Node>
 	typename Hierarchy<Node>::ConstPtr Hierarchy<Node>::GetRoot() const
 	{
-		if (auto lock = parent.lock())
-		{
-			return lock->GetRoot();
-		}
-		else
-		{
-			return GetPtr();
-		}
+		return GetRootNode()->GetPtr();
 	}
 
 	template<class Node>
 	typename Hierarchy<Node>::Ptr Hierarchy<Node>::GetRoot()
 	{
-		if (auto lock = parent.lock())
-		{
-			return lock->GetRoot();
-		}
-		else
-		{
-			return GetPtr();
-		}
+		return GetRootNode()->GetPtr();
 	}
 
 	template<class Node>
@@ -109,34 +190,132 @@ namespace Jwl
 		return parent.lock();
 	}
 
+	template<class Node>
+	Node* Hierarchy<Node>::GetParentNode() const
+	{
+		return parentNode;
+	}
+
 	template<class Node>
 	unsigned Hierarchy<Node>::GetNumChildren() const
 	{
 		return children.size();
 	}
 
+	template<class Node>
+	typename Hierarchy<Node>::template SubtreeRange<Node> Hierarchy<Node>::GetSubtree()
+	{
+		return SubtreeRange<Node>(*static_cast<Node*>(this));
+	}
+
+	template<class Node>
+	typename Hierarchy<Node>::template SubtreeRange<const Node> Hierarchy<Node>::GetSubtree() const
+	{
+		return SubtreeRange<const Node>(*static_cast<const Node*>(this));
+	}
+
 	template<class Node>
 	unsigned Hierarchy<Node>::GetDepth() const
 	{
-		if (auto lock = parent.lock())
+		return depth;
+	}
+
+	template<class Node>
+	bool Hierarchy<Node>::IsRoot() const
+	{
+		return parentNode == nullptr;
+	}
+
+	template<class Node>
+	bool Hierarchy<Node>::IsLeaf() const
+	{
+		return children.empty();
+	}
+
+	template<class Node>
+	u32 Hierarchy<Node>::GetSubtreeVersion() const
+	{
+		return subtreeVersion;
+	}
+
+	template<class Node>
+	void Hierarchy<Node>::MarkSubtreeChanged()
+	{
+		for (Hierarchy* node = this; node != nullptr && !node->isSubtreeMarked; node = node->parentNode)
 		{
-			return lock->GetDepth() + 1;
+			node->subtreeVersion++;
+			node->isSubtreeMarked = true;
 		}
-		else
+	}
+
+	template<class Node>
+	void Hierarchy<Node>::ClearSubtreeChanged()
+	{
+		// An unmarked node has no marked descendants, so the traversal is pruned to the marked branches.
+		VisitSubtree([](Hierarchy& node) {
+			if (!node.isSubtreeMarked)
+			{
+				return false;
+			}
+
+			node.isSubtreeMarked = false;
+			return true;
+		});
+	}
+
+	template<class Node> template<class Function>
+	void Hierarchy<Node>::VisitSubtree(Function&& visit)
+	{
+		Hierarchy* node = this;
+		bool descend = visit(*static_cast<Node*>(node));
+		u32 nextChild = 0;
+
+		while (true)
 		{
-			return 0;
+			if (descend && nextChild < node->children.size())
+			{
+				node = node->children[nextChild].get();
+				descend = visit(*static_cast<Node*>(node));
+				nextChild = 0;
+			}
+			else if (node != this)
+			{
+				// Continue with the next sibling.
+				nextChild = node->childIndex + 1;
+				node = node->parentNode;
+				descend = true;
+			}
+			else
+			{
+				break;
+			}
 		}
 	}
 
 	template<class Node>
-	bool Hierarchy<Node>::IsRoot() const
+	void Hierarchy<Node>::RefreshSubtree()
 	{
-		return parent.expired();
+		static_cast<Node*>(this)->OnParentChanged();
+
+		// Parents are visited first, so their links are always current by the time their children are refreshed.
+		for (Hierarchy& node : GetSubtree())
+		{
+			if (Hierarchy* nodeParent = node.parentNode)
+			{
+				node.depth = nodeParent->depth + 1;
+				node.rootNode = nodeParent->GetRootNode();
+			}
+			else
+			{
+				node.depth = 0;
+				node.rootNode = nullptr;
+			}
+		}
 	}
 
 	template<class Node>
-	bool Hierarchy<Node>::IsLeaf() const
+	Node* Hierarchy<Node>::GetRootNode() const
 	{
-		return children.empty();
+		return rootNode ? rootNode : const_cast<Node*>(static_cast<const Node*>(this));
 	}
 }
@@ -0,0 +1,88 @@
+// Copyright (c) 2017 Emilian Cioca
+#pragma once
+#include "Jewel3D/Application/Logging.h"
+#include "Jewel3D/Application/Types.h"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Jwl
+{
+	template<typename Signature, u32 Capacity = 4 * sizeof(void*)>
+	class InlineFunction;
+
+	//- A replacement for std::function which stores small callables, such as lambdas with a few captures, inside
+	//  of itself rather than on the heap. Callables larger than the Capacity are still allocated on the heap.
+	template<typename Result, typename... Args, u32 Capacity>
+	class InlineFunction<Result(Args...), Capacity>
+	{
+	public:
+		InlineFunction() = default;
+		InlineFunction(std::nullptr_t) {}
+		InlineFunction(const InlineFunction& other);
+		InlineFunction(InlineFunction&& other) noexcept;
+		~InlineFunction();
+
+		template<typename Func, typename = std::enable_if_t<!std::is_same<std::decay_t<Func>, InlineFunction>::value>>
+		InlineFunction(Func&& func);
+
+		InlineFunction& operator=(const InlineFunction& other);
+		InlineFunction& operator=(InlineFunction&& other) noexcept;
+		InlineFunction& operator=(std::nullptr_t);
+
+		template<typename Func, typename = std::enable_if_t<!std::is_same<std::decay_t<Func>, InlineFunction>::value>>
+		InlineFunction& operator=(Func&& func);
+
+		//- Invokes the callable. It must not be empty.
+		Result operator()(Args... args) const;
+
+		//- Returns true if a callable is stored.
+		explicit operator bool() const { return invoke != nullptr; }
+
+		//- Destroys the stored callable, if any.
+		void Reset();
+
+		//- Returns true if callables of the type are stored without allocating.
+		template<typename Func>
+		static constexpr bool IsStoredInline()
+		{
+			return sizeof(Func) <= Capacity &&
+				alignof(Func) <= alignof(Storage) &&
+				std::is_nothrow_move_constructible<Func>::value;
+		}
+
+	private:
+		enum class Operation
+		{
+			Copy,
+			Move,
+			Destroy
+		};
+
+		using Storage = std::aligned_storage_t<Capacity, alignof(std::max_align_t)>;
+		using Invoker = Result (*)(void* target, Args&&... args);
+		using Manager = void (*)(Operation op, void* dest, void* source);
+
+		template<typename Func>
+		void Assign(Func&& func, std::true_type /* isInline */);
+		template<typename Func>
+		void Assign(Func&& func, std::false_type /* isInline */);
+
+		void CopyFrom(const InlineFunction& other);
+		void MoveFrom(InlineFunction& other);
+
+		template<typename Func> static Result InvokeInline(void* target, Args&&... args);
+		template<typename Func> static Result InvokeHeap(void* target, Args&&... args);
+		template<typename Func> static void ManageInline(Operation op, void* dest, void* source);
+		template<typename Func> static void ManageHeap(Operation op, void* dest, void* source);
+
+		//- Holds either the callable itself, or a pointer to it on the heap.
+		mutable Storage storage;
+		Invoker invoke = nullptr;
+		Manager manage = nullptr;
+	};
+}
+
+#include "InlineFunction.inl"
@@ -0,0 +1,190 @@
+// Copyright (c) 2017 Emilian Cioca
+namespace Jwl
+{
+	template<typename Result, typename... Args, u32 Capacity>
+	InlineFunction<Result(Args...), Capacity>::InlineFunction(const InlineFunction& other)
+	{
+		CopyFrom(other);
+	}
+
+	template<typename Result, typename... Args, u32 Capacity>
+	InlineFunction<Result(Args...), Capacity>::InlineFunction(InlineFunction&& other) noexcept
+	{
+		MoveFrom(other);
+	}
+
+	template<typename Result, typename... Args, u32 Capacity>
+	InlineFunction<Result(Args...), Capacity>::~InlineFunction()
+	{
+		Reset();
+	}
+
+	template<typename Result, typename... Args, u32 Capacity> template<typename Func, typename>
+	InlineFunction<Result(Args...), Capacity>::InlineFunction(Func&& func)
+	{
+		using Target = std::decay_t<Func>;
+		Assign(std::forward<Func>(func), std::integral_constant<bool, IsStoredInline<Target>()>());
+	}
+
+	template<typename Result, typename... Args, u32 Capacity>
+	InlineFunction<Result(Args...), Capacity>& InlineFunction<Result(Args...), Capacity>::operator=(const InlineFunction& other)
+	{
+		if (this != &other)
+		{
+			Reset();
+			CopyFrom(other);
+		}
+
+		return *this;
+	}
+
+	template<typename Result, typename... Args, u32 Capacity>
+	InlineFunction<Result(Args...), Capacity>& InlineFunction<Result(Args...), Capacity>::operator=(InlineFunction&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			MoveFrom(other);
+		}
+
+		return *this;
+	}
+
+	template<typename Result, typename... Args, u32 Capacity>
+	InlineFunction<Result(Args...), Capacity>& InlineFunction<Result(Args...), Capacity>::operator=(std::nullptr_t)
+	{
+		Reset();
+		return *this;
+	}
+
+	template<typename Result, typename... Args, u32 Capacity> template<typename Func, typename>
+	InlineFunction<Result(Args...), Capacity>& InlineFunction<Result(Args...), Capacity>::operator=(Func&& func)
+	{
+		using Target = std::decay_t<Func>;
+
+		Reset();
+		Assign(std::forward<Func>(func), std::integral_constant<bool, IsStoredInline<Target>()>());
+
+		return *this;
+	}
+
+	template<typename Result, typename... Args, u32 Capacity>
+	Result InlineFunction<Result(Args...), Capacity>::operator()(Args... args) const
+	{
+		ASSERT(invoke != nullptr, "Cannot invoke an empty InlineFunction.");
+		return invoke(&storage, std::forward<Args>(args)...);
+	}
+
+	template<typename Result, typename... Args, u32 Capacity>
+	void InlineFunction<Result(Args...), Capacity>::Reset()
+	{
+		if (manage != nullptr)
+		{
+			manage(Operation::Destroy, nullptr, &storage);
+		}
+
+		invoke = nullptr;
+		manage = nullptr;
+	}
+
+	template<typename Result, typename... Args, u32 Capacity> template<typename Func>
+	void InlineFunction<Result(Args...), Capacity>::Assign(Func&& func, std::true_type)
+	{
+		using Target = std::decay_t<Func>;
+
+		new (&storage) Target(std::forward<Func>(func));
+		invoke = &InvokeInline<Target>;
+		manage = &ManageInline<Target>;
+	}
+
+	template<typename Result, typename... Args, u32 Capacity> template<typename Func>
+	void InlineFunction<Result(Args...), Capacity>::Assign(Func&& func, std::false_type)
+	{
+		using Target = std::decay_t<Func>;
+
+		*reinterpret_cast<Target**>(&storage) = new Target(std::forward<Func>(func));
+		invoke = &InvokeHeap<Target>;
+		manage = &ManageHeap<Target>;
+	}
+
+	template<typename Result, typename... Args, u32 Capacity>
+	void InlineFunction<Result(Args...), Capacity>::CopyFrom(const InlineFunction& other)
+	{
+		if (other.manage != nullptr)
+		{
+			other.manage(Operation::Copy, &storage, &other.storage);
+			invoke = other.invoke;
+			manage = other.manage;
+		}
+	}
+
+	template<typename Result, typename... Args, u32 Capacity>
+	void InlineFunction<Result(Args...), Capacity>::MoveFrom(InlineFunction& other)
+	{
+		if (other.manage != nullptr)
+		{
+			other.manage(Operation::Move, &storage, &other.storage);
+			invoke = other.invoke;
+			manage = other.manage;
+
+			other.invoke = nullptr;
+			other.manage = nullptr;
+		}
+	}
+
+	template<typename Result, typename... Args, u32 Capacity> template<typename Func>
+	Result InlineFunction<Result(Args...), Capacity>::InvokeInline(void* target, Args&&... args)
+	{
+		return (*static_cast<Func*>(target))(std::forward<Args>(args)...);
+	}
+
+	template<typename Result, typename... Args, u32 Capacity> template<typename Func>
+	Result InlineFunction<Result(Args...), Capacity>::InvokeHeap(void* target, Args&&... args)
+	{
+		return (**static_cast<Func**>(target))(std::forward<Args>(args)...);
+	}
+
+	template<typename Result, typename... Args, u32 Capacity> template<typename Func>
+	void InlineFunction<Result(Args...), Capacity>::ManageInline(Operation op, void* dest, void* source)
+	{
+		Func* func = static_cast<Func*>(source);
+
+		switch (op)
+		{
+		case Operation::Copy:
+			new (dest) Func(*func);
+			break;
+
+		case Operation::Move:
+			new (dest) Func(std::move(*func));
+			func->~Func();
+			break;
+
+		case Operation::Destroy:
+			func->~Func();
+			break;
+		}
+	}
+
+	template<typename Result, typename... Args, u32 Capacity> template<typename Func>
+	void InlineFunction<Result(Args...), Capacity>::ManageHeap(Operation op, void* dest, void* source)
+	{
+		Func*& func = *static_cast<Func**>(source);
+
+		switch (op)
+		{
+		case Operation::Copy:
+			*static_cast<Func**>(dest) = new Func(*func);
+			break;
+
+		case Operation::Move:
+			*static_cast<Func**>(dest) = func;
+			func = nullptr;
+			break;
+
+		case Operation::Destroy:
+			delete func;
+			break;
+		}
+	}
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2017 Emilian Cioca
+#pragma once
+#include "Jewel3D/Application/Logging.h"
+#include "Jewel3D/Application/Types.h"
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Jwl
+{
+	//- A FIFO queue of values stored contiguously in a circular buffer.
+	//- Values are constructed in place. The memory is kept when values are removed, so a buffer which
+	//  is repeatedly filled and emptied stops allocating once it has grown to its peak size.
+	template<typename T>
+	class RingBuffer
+	{
+	public:
+		RingBuffer() = default;
+		RingBuffer(const RingBuffer&) = delete;
+		RingBuffer& operator=(const RingBuffer&) = delete;
+		~RingBuffer();
+
+		//- Constructs a new value at the back of the queue.
+		template<typename... Args>
+		T& Emplace(Args&&... args);
+
+		//- Destroys the value at the front of the queue.
+		void PopFront();
+
+		//- Destroys all values. The memory is kept for reuse.
+		void Clear();
+
+		//- Prepares the buffer to hold the specified number of values without reallocating.
+		void Reserve(u32 capacity);
+
+		T& Front();
+		const T& Front() const;
+
+		//- Access by position, starting from the front of the queue.
+		T& operator[](u32 index);
+		const T& operator[](u32 index) const;
+
+		u32 Size() const { return count; }
+		bool IsEmpty() const { return count == 0; }
+		u32 GetCapacity() const { return capacity; }
+
+	private:
+		using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+		T* GetSlot(u32 index) const;
+
+		std::unique_ptr<Storage[]> buffer;
+		//- Always a power of two, so that positions can be wrapped with a mask.
+		u32 capacity = 0;
+		u32 head = 0;
+		u32 count = 0;
+	};
+}
+
+#include "RingBuffer.inl"
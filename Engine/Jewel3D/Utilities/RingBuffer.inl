@@ -0,0 +1,108 @@
+// Copyright (c) 2017 Emilian Cioca
+namespace Jwl
+{
+	template<typename T>
+	RingBuffer<T>::~RingBuffer()
+	{
+		Clear();
+	}
+
+	template<typename T> template<typename... Args>
+	T& RingBuffer<T>::Emplace(Args&&... args)
+	{
+		if (count == capacity)
+		{
+			Reserve(capacity == 0 ? 16 : capacity * 2);
+		}
+
+		T* slot = GetSlot(count);
+		new (slot) T(std::forward<Args>(args)...);
+		count++;
+
+		return *slot;
+	}
+
+	template<typename T>
+	void RingBuffer<T>::PopFront()
+	{
+		ASSERT(count > 0, "RingBuffer is empty.");
+
+		GetSlot(0)->~T();
+		head = (head + 1) & (capacity - 1);
+		count--;
+	}
+
+	template<typename T>
+	void RingBuffer<T>::Clear()
+	{
+		for (u32 i = 0; i < count; ++i)
+		{
+			GetSlot(i)->~T();
+		}
+
+		head = 0;
+		count = 0;
+	}
+
+	template<typename T>
+	void RingBuffer<T>::Reserve(u32 newCapacity)
+	{
+		if (newCapacity <= capacity)
+		{
+			return;
+		}
+
+		u32 roundedCapacity = 1;
+		while (roundedCapacity < newCapacity)
+		{
+			roundedCapacity <<= 1;
+		}
+
+		// Move the values to the start of the new buffer, unwrapping them in the process.
+		std::unique_ptr<Storage[]> newBuffer(new Storage[roundedCapacity]);
+		for (u32 i = 0; i < count; ++i)
+		{
+			T* slot = GetSlot(i);
+			new (&newBuffer[i]) T(std::move(*slot));
+			slot->~T();
+		}
+
+		buffer = std::move(newBuffer);
+		capacity = roundedCapacity;
+		head = 0;
+	}
+
+	template<typename T>
+	T& RingBuffer<T>::Front()
+	{
+		ASSERT(count > 0, "RingBuffer is empty.");
+		return *GetSlot(0);
+	}
+
+	template<typename T>
+	const T& RingBuffer<T>::Front() const
+	{
+		ASSERT(count > 0, "RingBuffer is empty.");
+		return *GetSlot(0);
+	}
+
+	template<typename T>
+	T& RingBuffer<T>::operator[](u32 index)
+	{
+		ASSERT(index < count, "Index out of range.");
+		return *GetSlot(index);
+	}
+
+	template<typename T>
+	const T& RingBuffer<T>::operator[](u32 index) const
+	{
+		ASSERT(index < count, "Index out of range.");
+		return *GetSlot(index);
+	}
+
+	template<typename T>
+	T* RingBuffer<T>::GetSlot(u32 index) const
+	{
+		return reinterpret_cast<T*>(&buffer[(head + index) & (capacity - 1)]);
+	}
+}
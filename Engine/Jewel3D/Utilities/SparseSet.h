@@ -0,0 +1,82 @@
+// Copyright (c) 2017 Emilian Cioca
+#pragma once
+#include "Jewel3D/Application/Logging.h"
+#include "Jewel3D/Application/Types.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace Jwl
+{
+	//- Associates small integer keys with values, supporting O(1) insertion, removal, and lookup.
+	//- Values are packed into a dense array which can be iterated directly. Removal swaps the last
+	//  element into the vacated position, so the order of the dense array is not stable.
+	//- The sparse lookup is paged, so large keys only cost memory for the pages that they touch.
+	template<typename Value>
+	class SparseSet
+	{
+	public:
+		//- The value returned by IndexOf() for keys that are not present.
+		static constexpr u32 InvalidIndex = ~0u;
+
+		SparseSet() = default;
+		SparseSet(const SparseSet&) = delete;
+		SparseSet(SparseSet&&) = default;
+		SparseSet& operator=(const SparseSet&) = delete;
+		SparseSet& operator=(SparseSet&&) = default;
+
+		//- Adds the key and its value. The key must not already be present.
+		void Insert(u32 key, const Value& value);
+
+		//- Removes the key and its value if present. Returns true if the key was found.
+		bool Remove(u32 key);
+
+		//- Like Remove(), but shifts the following elements down instead, preserving the order of the dense array.
+		//- This is O(n) in the number of elements following the removed one.
+		bool RemoveOrdered(u32 key);
+
+		//- Returns true if the key is present.
+		bool Contains(u32 key) const;
+
+		//- Returns the position of the key in the dense array, or InvalidIndex.
+		u32 IndexOf(u32 key) const;
+
+		//- Removes all keys.
+		void Clear();
+
+		//- Prepares the dense array to hold the specified number of elements without reallocating.
+		void Reserve(u32 capacity);
+
+		u32 Size() const { return values.size(); }
+		bool IsEmpty() const { return values.empty(); }
+
+		//- Access to the dense array.
+		Value& operator[](u32 index) { return values[index]; }
+		const Value& operator[](u32 index) const { return values[index]; }
+		u32 GetKey(u32 index) const { return keys[index]; }
+
+		const std::vector<Value>& GetValues() const { return values; }
+		const std::vector<u32>& GetKeys() const { return keys; }
+
+		auto begin() { return values.begin(); }
+		auto end() { return values.end(); }
+		auto begin() const { return values.begin(); }
+		auto end() const { return values.end(); }
+
+	private:
+		static constexpr u32 PageBits = 10;
+		static constexpr u32 PageSize = 1u << PageBits;
+
+		u32* FindSlot(u32 key) const;
+		u32& AcquireSlot(u32 key);
+
+		std::vector<Value> values;
+		std::vector<u32> keys;
+
+		//- Maps keys to their position in the dense arrays.
+		std::vector<std::unique_ptr<u32[]>> pages;
+	};
+}
+
+#include "SparseSet.inl"
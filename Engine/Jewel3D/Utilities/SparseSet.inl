@@ -0,0 +1,129 @@
+// Copyright (c) 2017 Emilian Cioca
+namespace Jwl
+{
+	template<typename Value> constexpr u32 SparseSet<Value>::InvalidIndex;
+	template<typename Value> constexpr u32 SparseSet<Value>::PageBits;
+	template<typename Value> constexpr u32 SparseSet<Value>::PageSize;
+
+	template<typename Value>
+	void SparseSet<Value>::Insert(u32 key, const Value& value)
+	{
+		u32& slot = AcquireSlot(key);
+		ASSERT(slot == InvalidIndex, "Key is already part of the SparseSet.");
+
+		slot = values.size();
+		values.push_back(value);
+		keys.push_back(key);
+	}
+
+	template<typename Value>
+	bool SparseSet<Value>::Remove(u32 key)
+	{
+		u32* slot = FindSlot(key);
+		if (slot == nullptr || *slot == InvalidIndex)
+		{
+			return false;
+		}
+
+		// Move the last element into the vacated position.
+		const u32 index = *slot;
+		const u32 last = values.size() - 1;
+		if (index != last)
+		{
+			values[index] = std::move(values[last]);
+			keys[index] = keys[last];
+			*FindSlot(keys[index]) = index;
+		}
+
+		values.pop_back();
+		keys.pop_back();
+		*slot = InvalidIndex;
+
+		return true;
+	}
+
+	template<typename Value>
+	bool SparseSet<Value>::RemoveOrdered(u32 key)
+	{
+		u32* slot = FindSlot(key);
+		if (slot == nullptr || *slot == InvalidIndex)
+		{
+			return false;
+		}
+
+		const u32 index = *slot;
+		values.erase(values.begin() + index);
+		keys.erase(keys.begin() + index);
+		*slot = InvalidIndex;
+
+		// Every following key has moved down by one.
+		for (u32 i = index; i < keys.size(); ++i)
+		{
+			*FindSlot(keys[i]) = i;
+		}
+
+		return true;
+	}
+
+	template<typename Value>
+	bool SparseSet<Value>::Contains(u32 key) const
+	{
+		return IndexOf(key) != InvalidIndex;
+	}
+
+	template<typename Value>
+	u32 SparseSet<Value>::IndexOf(u32 key) const
+	{
+		const u32* slot = FindSlot(key);
+		return slot ? *slot : InvalidIndex;
+	}
+
+	template<typename Value>
+	void SparseSet<Value>::Clear()
+	{
+		for (u32 key : keys)
+		{
+			*FindSlot(key) = InvalidIndex;
+		}
+
+		values.clear();
+		keys.clear();
+	}
+
+	template<typename Value>
+	void SparseSet<Value>::Reserve(u32 capacity)
+	{
+		values.reserve(capacity);
+		keys.reserve(capacity);
+	}
+
+	template<typename Value>
+	u32* SparseSet<Value>::FindSlot(u32 key) const
+	{
+		const u32 page = key >> PageBits;
+		if (page >= pages.size() || !pages[page])
+		{
+			return nullptr;
+		}
+
+		return &pages[page][key & (PageSize - 1)];
+	}
+
+	template<typename Value>
+	u32& SparseSet<Value>::AcquireSlot(u32 key)
+	{
+		const u32 page = key >> PageBits;
+		if (page >= pages.size())
+		{
+			pages.resize(page + 1);
+		}
+
+		if (!pages[page])
+		{
+			pages[page] = std::make_unique<u32[]>(PageSize);
+			std::fill_n(pages[page].get(), PageSize, InvalidIndex);
+		}
+
+		return pages[page][key & (PageSize - 1)];
+	}
+}
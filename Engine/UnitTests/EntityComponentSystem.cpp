@@ -1,5 +1,18 @@
 #include <catch.hpp>
+#include <Jewel3D/Application/Logging.h>
+#include <Jewel3D/Application/Timer.h>
 #include <Jewel3D/Entity/Entity.h>
+#include <Jewel3D/Entity/EntityCommandBuffer.h>
+#include <Jewel3D/Entity/EntityGroup.h>
+#include <Jewel3D/Entity/Name.h>
+#include <Jewel3D/Entity/Prefab.h>
+#include <Jewel3D/Entity/Serialization.h>
+#include <Jewel3D/Entity/SystemScheduler.h>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <utility>
 
 using namespace Jwl;
 
@@ -41,10 +54,66 @@ public:
 	DerivedB(Entity& owner) : Base(owner) {}
 };
 
+//- Records how many times it has been visited by a query.
+class Counter : public Component<Counter>
+{
+public:
+	Counter(Entity& owner) : Component(owner) {}
+
+	u32 visits = 0;
+};
+
 class TagA : public Tag<TagA> {};
 class TagB : public Tag<TagB> {};
 class TagC : public Tag<TagC> {};
 
+//- A family of distinct Component types, used to populate Entities with many Components.
+template<u32 N>
+class Numbered : public Component<Numbered<N>>
+{
+public:
+	Numbered(Entity& owner) : Component<Numbered<N>>(owner) {}
+};
+
+using NumberedSequence = std::make_integer_sequence<u32, 32>;
+
+//- The lookup strategy used before Entities had a ComponentMap.
+//- A linear scan which dereferences every Component to compare its ID.
+ComponentBase* LinearLookup(const std::vector<ComponentBase*>& components, u32 id)
+{
+	for (auto comp : components)
+	{
+		if (comp->componentId == id)
+		{
+			return comp;
+		}
+	}
+
+	return nullptr;
+}
+
+template<u32... I>
+void AddNumbered(Entity& ent, u32 count, std::vector<ComponentBase*>& outComponents, std::integer_sequence<u32, I...>)
+{
+	EXECUTE_PACK(I < count ? (outComponents.push_back(&ent.Add<Numbered<I>>()), 0) : 0);
+}
+
+template<u32... I>
+u32 LookupMapped(const Entity& ent, std::integer_sequence<u32, I...>)
+{
+	u32 found = 0;
+	EXECUTE_PACK(found += ent.Try<Numbered<I>>() != nullptr ? 1 : 0);
+	return found;
+}
+
+template<u32... I>
+u32 LookupLinear(const std::vector<ComponentBase*>& components, std::integer_sequence<u32, I...>)
+{
+	u32 found = 0;
+	EXECUTE_PACK(found += LinearLookup(components, Numbered<I>::GetComponentId()) != nullptr ? 1 : 0);
+	return found;
+}
+
 TEST_CASE("Entity-Component-System")
 {
 	SECTION("Adding/Removing Components")
@@ -147,6 +216,37 @@ TEST_CASE("Entity-Component-System")
 		CHECK(!ent->HasTag<TagC>());
 	}
 
+	SECTION("Many Components")
+	{
+		auto ent = Entity::MakeNew();
+		std::vector<ComponentBase*> components;
+		AddNumbered(*ent, 32, components, NumberedSequence());
+		ent->Tag<TagA>();
+		ent->Tag<TagB>();
+
+		CHECK(LookupMapped(*ent, NumberedSequence()) == 32);
+		CHECK(&ent->Get<Numbered<0>>() == components[0]);
+		CHECK(&ent->Get<Numbered<31>>() == components[31]);
+
+		ent->RemoveComponent<Numbered<7>>();
+		ent->RemoveComponent<Numbered<8>>();
+		ent->RemoveComponent<Numbered<30>>();
+		ent->RemoveTag<TagA>();
+
+		CHECK(LookupMapped(*ent, NumberedSequence()) == 29);
+		CHECK(!ent->Has<Numbered<7>>());
+		CHECK(!ent->Has<Numbered<8>>());
+		CHECK(!ent->Has<Numbered<30>>());
+		CHECK(ent->Has<Numbered<31>>());
+		CHECK(!ent->HasTag<TagA>());
+		CHECK(ent->HasTag<TagB>());
+		CHECK(!ent->HasTag<TagC>());
+
+		ent->RemoveAllComponents();
+		CHECK(LookupMapped(*ent, NumberedSequence()) == 0);
+		CHECK(ent->HasTag<TagB>());
+	}
+
 	SECTION("Enabling / Disabling")
 	{
 		auto ent1 = Entity::MakeNew();
@@ -234,6 +334,827 @@ TEST_CASE("Entity-Component-System")
 		}
 	}
 
+	SECTION("Component Storage")
+	{
+		// Enough instances to span several chunks.
+		const u32 numEntities = World::GetDefault().GetStorage<Comp1>().GetChunkCapacity() * 3 + 1;
+
+		std::vector<Entity::Ptr> entities;
+		std::vector<Comp1*> components;
+		for (u32 i = 0; i < numEntities; i++)
+		{
+			entities.push_back(Entity::MakeNew());
+			components.push_back(&entities.back()->Add<Comp1>());
+		}
+
+		// Holes left by removed or disabled components must be skipped.
+		for (u32 i = 0; i < numEntities; i += 2)
+		{
+			entities[i]->RemoveComponent<Comp1>();
+		}
+		entities[1]->Disable<Comp1>();
+		entities[3]->Disable();
+
+		auto count = 0u;
+		for (Comp1& comp : All<Comp1>())
+		{
+			count++;
+			CHECK(comp.IsEnabled());
+		}
+		CHECK(count == numEntities / 2 - 2);
+
+		// Existing components never move as others are created or destroyed.
+		for (u32 i = 1; i < numEntities; i += 2)
+		{
+			CHECK(&entities[i]->Get<Comp1>() == components[i]);
+		}
+
+		// Recycled slots are visible to queries again.
+		for (u32 i = 0; i < numEntities; i += 2)
+		{
+			entities[i]->Add<Comp1>();
+		}
+
+		count = 0;
+		for (Comp1& comp : All<Comp1>())
+		{
+			count++;
+		}
+		CHECK(count == numEntities - 2);
+
+		// Indirect inheritors are queried under their base.
+		entities[0]->Add<DerivedA>();
+		entities[1]->Add<DerivedB>();
+		entities[2]->Add<Base>();
+
+		count = 0;
+		for (Base& comp : All<Base>())
+		{
+			count++;
+		}
+		CHECK(count == 3);
+	}
+
+	SECTION("Index Churn")
+	{
+		// Enough Entities to span several pages of the sparse index tables.
+		const u32 numEntities = 3000;
+
+		std::vector<Entity::Ptr> entities;
+		for (u32 i = 0; i < numEntities; i++)
+		{
+			entities.push_back(Entity::MakeNew());
+			entities.back()->Add<Comp1>();
+			entities.back()->Tag<TagA>();
+
+			if (i % 3 == 0)
+			{
+				entities.back()->Add<Comp2>();
+			}
+		}
+
+		// Entities are despawned and disabled in an order unrelated to their creation.
+		for (u32 i = 0; i < numEntities; i += 2)
+		{
+			entities[i].reset();
+		}
+
+		for (u32 i = 1; i < numEntities; i += 4)
+		{
+			entities[i]->Disable();
+		}
+
+		u32 expected = 0;
+		for (u32 i = 0; i < numEntities; i++)
+		{
+			if (entities[i] && entities[i]->IsEnabled() && entities[i]->Has<Comp2>())
+			{
+				expected++;
+			}
+		}
+
+		u32 count = 0;
+		for (Entity& e : With<TagA, Comp1, Comp2>())
+		{
+			count++;
+			CHECK(e.IsEnabled());
+			CHECK(e.Has<Comp2>());
+		}
+		CHECK(count == expected);
+
+		// IDs of destroyed Entities are recycled, and remain unique among living Entities.
+		auto recycled = Entity::MakeNew();
+		for (auto& ent : entities)
+		{
+			if (ent)
+			{
+				CHECK(ent->GetId() != recycled->GetId());
+			}
+		}
+		CHECK(recycled->GetId() < numEntities);
+	}
+
+	SECTION("Entity Handles")
+	{
+		EntityHandle null;
+		CHECK(!null.IsValid());
+		CHECK(null.Get() == nullptr);
+
+		auto ent = Entity::MakeNew();
+		EntityHandle handle = ent->GetHandle();
+		CHECK(handle.IsValid());
+		CHECK(handle.Get() == ent.get());
+		CHECK(handle.GetIndex() == ent->GetId());
+		CHECK(handle == ent->GetHandle());
+		CHECK(handle != null);
+
+		// The packed value resolves to the same Entity.
+		EntityHandle unpacked(handle.GetValue());
+		CHECK(unpacked == handle);
+		CHECK(unpacked.Get() == ent.get());
+
+		// A recycled ID doesn't revive old handles.
+		const u32 id = ent->GetId();
+		ent.reset();
+		CHECK(!handle.IsValid());
+
+		auto recycled = Entity::MakeNew();
+		CHECK(recycled->GetId() == id);
+		CHECK(recycled->GetHandle() != handle);
+		CHECK(!handle.IsValid());
+		CHECK(recycled->GetHandle().Get() == recycled.get());
+
+		// Commands recorded for Entities that are gone by playback are skipped.
+		auto doomed = Entity::MakeNew();
+		EntityCommandBuffer commands;
+		commands.Add<Comp1>(*doomed);
+		commands.Add<Comp1>(*recycled);
+		doomed.reset();
+		commands.Playback();
+		CHECK(recycled->Has<Comp1>());
+	}
+
+	SECTION("Worlds")
+	{
+		auto defaultEnt = Entity::MakeNew();
+		defaultEnt->Add<Comp1>();
+		CHECK(&defaultEnt->GetWorld() == &World::GetDefault());
+
+		World world;
+		CHECK(world.GetIndex() != World::GetDefault().GetIndex());
+		{
+			auto ent = world.CreateEntity();
+			ent->Add<Comp1>();
+			ent->Tag<TagA>();
+			CHECK(&ent->GetWorld() == &world);
+			CHECK(&ent->CreateChild()->GetWorld() == &world);
+			CHECK(&ent->Duplicate()->GetWorld() == &world);
+
+			// Each World only sees its own Entities.
+			CHECK(std::distance(world.With<Comp1, TagA>().begin(), world.With<Comp1, TagA>().end()) == 1);
+			CHECK(&*world.With<Comp1>().begin() == ent.get());
+			CHECK(&*With<Comp1>().begin() == defaultEnt.get());
+			CHECK(&world.All<Comp1>().begin()->owner == ent.get());
+			CHECK(std::distance(All<Comp1>().begin(), All<Comp1>().end()) == 1);
+
+			Query<Comp1> query(world);
+			CHECK(query.Size() == 1);
+			CHECK(query.Contains(*ent));
+			CHECK(!query.Contains(*defaultEnt));
+
+			// IDs are per-World, but handles are not.
+			CHECK(ent->GetHandle() != defaultEnt->GetHandle());
+			CHECK(ent->GetHandle().Get() == ent.get());
+			CHECK(EntityHandle(ent->GetHandle().GetValue()).Get() == ent.get());
+		}
+		CHECK(world.GetNumEntities() == 0);
+
+		// Separate Worlds can be simulated on separate threads at the same time.
+		constexpr u32 numWorlds = 4;
+		std::vector<std::unique_ptr<World>> worlds;
+		std::vector<std::thread> threads;
+		std::atomic<u32> visits(0);
+		for (u32 i = 0; i < numWorlds; ++i)
+		{
+			worlds.push_back(std::make_unique<World>());
+			threads.emplace_back([&visits, &world = *worlds.back()] {
+				std::vector<Entity::Ptr> entities;
+				for (u32 j = 0; j < 1000; ++j)
+				{
+					entities.push_back(world.CreateEntity());
+					entities.back()->Add<Counter>();
+				}
+
+				world.ParallelForEach<Counter>([](Counter& counter) { counter.visits++; });
+				for (Entity& ent : world.With<Counter>())
+				{
+					visits += ent.Get<Counter>().visits;
+				}
+			});
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		CHECK(visits == numWorlds * 1000);
+		CHECK(std::distance(All<Counter>().begin(), All<Counter>().end()) == 0);
+
+		// Handles to the Entities of a destroyed World don't resolve in the next World to reuse its index.
+		EntityHandle stale;
+		u32 staleWorldIndex;
+		{
+			auto expired = std::make_unique<World>();
+			staleWorldIndex = expired->GetIndex();
+			stale = expired->CreateEntity()->GetHandle();
+			CHECK(!stale);
+		}
+		{
+			World successor;
+			REQUIRE(successor.GetIndex() == staleWorldIndex);
+
+			auto ent = successor.CreateEntity();
+			CHECK(ent->GetHandle().GetIndex() == stale.GetIndex());
+			CHECK(ent->GetHandle() != stale);
+			CHECK(stale.Get() == nullptr);
+		}
+	}
+
+	SECTION("Pooled Allocation")
+	{
+		// Weak references may outlive the World.
+		Entity::WeakPtr weak;
+
+		World world;
+		auto spawn = [&world] {
+			std::vector<Entity::Ptr> entities;
+			for (u32 i = 0; i < 500; ++i)
+			{
+				entities.push_back(world.CreateEntity());
+				entities.back()->AddComponents<Comp1, Comp2>();
+			}
+			return entities;
+		};
+
+		auto entities = spawn();
+		auto stats = world.GetAllocationStats();
+		CHECK(stats.numEntities == 500);
+		CHECK(stats.numComponents == 1000);
+		CHECK(stats.entityCapacity >= 500);
+		CHECK(stats.componentCapacity >= 1000);
+
+		// Once the pools have grown, churn is served entirely from recycled memory.
+		const u32 heapAllocations = stats.heapAllocations;
+		for (u32 wave = 0; wave < 3; ++wave)
+		{
+			entities.clear();
+			CHECK(world.GetAllocationStats().numEntities == 0);
+			CHECK(world.GetAllocationStats().numComponents == 0);
+
+			entities = spawn();
+		}
+
+		stats = world.GetAllocationStats();
+		CHECK(stats.heapAllocations == heapAllocations);
+		CHECK(stats.totalEntityAllocations == 2000);
+		CHECK(stats.totalComponentAllocations == 4000);
+
+		weak = entities.front();
+		entities.clear();
+		CHECK(weak.expired());
+	}
+
+	SECTION("Prefabs")
+	{
+		auto source = Entity::MakeNew("Enemy");
+		source->SetPosition(vec3(1.0f, 2.0f, 3.0f));
+		source->Add<Counter>().visits = 7;
+		source->Tag<TagA>();
+		auto child = source->CreateChild();
+		child->Add<Comp1>();
+		child->Add<Comp2>();
+		child->Disable<Comp2>();
+		auto hiddenChild = source->CreateChild();
+		hiddenChild->Add<Comp1>();
+		hiddenChild->Disable();
+
+		Prefab prefab(*source);
+		CHECK(prefab.GetNumEntities() == 3);
+
+		// The prefab is a snapshot. Its hidden state is never visible to queries.
+		source->Get<Counter>().visits = 0;
+		source.reset();
+		child.reset();
+		hiddenChild.reset();
+		CHECK(With<Counter>().begin() == With<Counter>().end());
+
+		Query<Counter, TagA> enemies;
+		auto copies = prefab.Instantiate(100);
+		REQUIRE(copies.size() == 100);
+		CHECK(enemies.Size() == 100);
+		CHECK(std::distance(With<Comp1>().begin(), With<Comp1>().end()) == 100);
+		CHECK(With<Comp2>().begin() == With<Comp2>().end());
+
+		for (auto& copy : copies)
+		{
+			CHECK(copy->IsEnabled());
+			CHECK(copy->GetPosition() == vec3(1.0f, 2.0f, 3.0f));
+			CHECK(copy->Get<Counter>().visits == 7);
+			CHECK(copy->Get<Name>().GetName() == "Enemy");
+			CHECK(copy->GetNumChildren() == 2);
+
+			auto& children = copy->GetChildren();
+			CHECK(children[0]->IsEnabled());
+			CHECK(children[0]->Get<Comp1>().IsEnabled());
+			CHECK(!children[0]->Get<Comp2>().IsComponentEnabled());
+			CHECK(!children[1]->IsEnabled());
+
+			// Enabling behaves as usual afterwards.
+			children[0]->Enable<Comp2>();
+		}
+		CHECK(std::distance(With<Comp2>().begin(), With<Comp2>().end()) == 100);
+
+		auto single = prefab.Instantiate();
+		CHECK(enemies.Size() == 101);
+		CHECK(single->GetChildren()[1]->Has<Comp1>());
+	}
+
+	SECTION("Names")
+	{
+		auto root = Entity::MakeNew("Root");
+		auto child = root->CreateChild();
+		child->Add<Name>("Target");
+		auto grandChild = child->CreateChild();
+		grandChild->Add<Name>("Target");
+		auto other = Entity::MakeNew("Target");
+
+		CHECK(FindEntity("Root") == root);
+		CHECK(FindEntity("Missing") == nullptr);
+		CHECK(FindChild(*root, "Target") == child);
+		CHECK(FindChild(*child, "Target") == grandChild);
+		CHECK(FindChild(*other, "Target") == nullptr);
+
+		// Interned names refer to the same strings.
+		NameId target("Target");
+		CHECK(target == child->Get<Name>().GetNameId());
+		CHECK(target.GetString() == "Target");
+		CHECK(NameId() == NameId(""));
+		CHECK(FindChild(*root, target) == child);
+
+		// The index follows renames and removals.
+		child->Get<Name>().SetName("Renamed");
+		CHECK(FindChild(*root, target) == grandChild);
+		CHECK(FindChild(*root, "Renamed") == child);
+		grandChild->RemoveComponent<Name>();
+		CHECK(FindChild(*root, target) == nullptr);
+
+		// Disabled Entities are skipped by FindEntity().
+		root->Disable();
+		CHECK(FindEntity("Root") == nullptr);
+		root->Enable();
+		CHECK(FindEntity("Root") == root);
+
+		auto copy = root->Duplicate();
+		CHECK(FindEntity("Root_Copy") == copy);
+
+		// Each World has its own index.
+		World world;
+		{
+			auto local = world.CreateEntity();
+			local->Add<Name>("Local");
+			CHECK(FindEntity("Local", world) == local);
+			CHECK(FindEntity("Local") == nullptr);
+			CHECK(FindEntity("Root", world) == nullptr);
+		}
+	}
+
+	SECTION("Enabling / Disabling Subtrees")
+	{
+		auto root = Entity::MakeNew();
+		root->Add<Comp1>();
+		auto& base = root->Add<Base>();
+		std::vector<Entity::Ptr> descendants;
+		for (u32 i = 0; i < 10; ++i)
+		{
+			auto child = root->CreateChild();
+			child->Add<Comp1>();
+			child->Tag<TagA>();
+			auto grandChild = child->CreateChild();
+			grandChild->Add<Comp1>();
+			grandChild->Add<Comp2>();
+			grandChild->Disable<Comp2>();
+
+			descendants.push_back(child);
+			descendants.push_back(grandChild);
+		}
+		auto disabledChild = descendants[0];
+		disabledChild->Disable();
+
+		Query<Comp1> query;
+		CHECK(query.Size() == 20);
+
+		root->DisableSubtree();
+		CHECK(!root->IsEnabled());
+		CHECK(base.onDisableCalled);
+		CHECK(query.Size() == 0);
+		CHECK(With<Comp1>().begin() == With<Comp1>().end());
+		CHECK(With<TagA>().begin() == With<TagA>().end());
+		CHECK(All<Comp1>().begin() == All<Comp1>().end());
+
+		root->EnableSubtree();
+		CHECK(base.onEnableCalled);
+		CHECK(query.Size() == 21);
+		CHECK(disabledChild->IsEnabled());
+		CHECK(std::distance(With<TagA>().begin(), With<TagA>().end()) == 10);
+		CHECK(std::distance(All<Comp1>().begin(), All<Comp1>().end()) == 21);
+
+		// Disabled components stay disabled.
+		CHECK(With<Comp2>().begin() == With<Comp2>().end());
+		for (auto& ent : descendants)
+		{
+			CHECK(ent->IsEnabled());
+		}
+	}
+
+	SECTION("Entity Groups")
+	{
+		std::vector<Entity::Ptr> entities;
+		for (u32 i = 0; i < 5; ++i)
+		{
+			entities.push_back(Entity::MakeNew());
+		}
+
+		EntityGroup unordered;
+		EntityGroup stable(EntityGroup::Order::Stable);
+		for (auto& ent : entities)
+		{
+			unordered.Add(ent);
+			stable.Add(ent);
+		}
+
+		CHECK(unordered.Size() == 5);
+		CHECK(unordered.Has(*entities[1]));
+
+		unordered.Remove(*entities[1]);
+		stable.Remove(*entities[1]);
+		CHECK(!unordered.Has(*entities[1]));
+		CHECK(!stable.Has(*entities[1]));
+		CHECK(unordered.Has(*entities[4]));
+		CHECK(unordered.GetEntities()[1] == entities[4]);
+		CHECK(stable.GetEntities() == std::vector<Entity::Ptr>({ entities[0], entities[2], entities[3], entities[4] }));
+
+		// Removing an Entity that isn't part of the group has no effect.
+		stable.Remove(*entities[1]);
+		CHECK(stable.Size() == 4);
+		stable.Remove(*entities[3]);
+		CHECK(stable.GetEntities() == std::vector<Entity::Ptr>({ entities[0], entities[2], entities[4] }));
+
+		// IDs are only unique within a World.
+		World world;
+		auto foreign = world.CreateEntity();
+		CHECK(!stable.Has(*foreign));
+		stable.Remove(*foreign);
+		CHECK(stable.Size() == 3);
+
+		unordered.Clear();
+		CHECK(unordered.Size() == 0);
+		CHECK(!unordered.Has(*entities[0]));
+		unordered.Add(foreign);
+		CHECK(unordered.Has(*foreign));
+		unordered.Clear();
+	}
+
+	SECTION("World Transforms")
+	{
+		auto root = Entity::MakeNew();
+		auto middle = root->CreateChild();
+		auto leaf = middle->CreateChild();
+
+		root->SetPosition(vec3(1.0f, 0.0f, 0.0f));
+		middle->SetPosition(vec3(0.0f, 2.0f, 0.0f));
+		leaf->SetPosition(vec3(0.0f, 0.0f, 3.0f));
+		CHECK(leaf->GetWorldTransform().GetTranslation() == vec3(1.0f, 2.0f, 3.0f));
+
+		// Changes to any ancestor are picked up, even though the leaf itself didn't move.
+		root->SetPosition(vec3(-1.0f, 0.0f, 0.0f));
+		CHECK(leaf->GetWorldTransform().GetTranslation() == vec3(-1.0f, 2.0f, 3.0f));
+
+		middle->SetScale(vec3(2.0f));
+		CHECK(leaf->GetWorldTransform().GetTranslation() == vec3(-1.0f, 2.0f, 6.0f));
+
+		// The batched update agrees with the lazy one.
+		middle->RotateY(90.0f);
+		leaf->SetPosition(vec3(0.0f, 0.0f, 1.0f));
+		Entity::UpdateWorldTransforms();
+		CHECK(leaf->GetWorldTransform().GetTranslation() == (middle->GetWorldTransform() * vec4(leaf->GetPosition(), 1.0f)).ToVec3());
+
+		// The version only advances when the world transform actually changes.
+		const u64 version = leaf->GetWorldTransformVersion();
+		CHECK(leaf->GetWorldTransform().GetTranslation() == (middle->GetWorldTransform() * vec4(leaf->GetPosition(), 1.0f)).ToVec3());
+		CHECK(leaf->GetWorldTransformVersion() == version);
+
+		root->SetPosition(root->GetPosition() + vec3(0.0f, 1.0f, 0.0f));
+		leaf->GetWorldTransform();
+		CHECK(leaf->GetWorldTransformVersion() > version);
+
+		// Changing parents is picked up as well.
+		auto other = Entity::MakeNew();
+		other->SetPosition(vec3(10.0f, 0.0f, 0.0f));
+		other->AddChild(leaf);
+		CHECK(leaf->GetWorldTransform().GetTranslation() == vec3(10.0f, 0.0f, 1.0f));
+
+		other->RemoveChild(*leaf);
+		CHECK(leaf->GetWorldTransform().GetTranslation() == vec3(0.0f, 0.0f, 1.0f));
+
+		// The batched update refreshes every descendant of a moved Entity, even if some were refreshed along the way.
+		auto sibling = middle->CreateChild();
+		sibling->SetPosition(vec3(0.0f, 0.0f, 1.0f));
+		Entity::UpdateWorldTransforms();
+		const u64 siblingVersion = sibling->GetWorldTransformVersion();
+
+		root->SetPosition(vec3(5.0f, 0.0f, 0.0f));
+		middle->CreateChild()->GetWorldTransform();
+		Entity::UpdateWorldTransforms();
+		CHECK(sibling->GetWorldTransformVersion() > siblingVersion);
+		CHECK(sibling->GetWorldTransform().GetTranslation() == (middle->GetWorldTransform() * vec4(sibling->GetPosition(), 1.0f)).ToVec3());
+
+		// Entities which didn't move are left alone.
+		const u64 rootVersion = root->GetWorldTransformVersion();
+		other->SetPosition(vec3(0.0f));
+		Entity::UpdateWorldTransforms();
+		CHECK(root->GetWorldTransformVersion() == rootVersion);
+
+		// Moved Entities below up to date ones are found, without refreshing their ancestors.
+		const u64 middleVersion = middle->GetWorldTransformVersion();
+		sibling->SetPosition(vec3(0.0f, 0.0f, 2.0f));
+		other->SetPosition(vec3(2.0f));
+		Entity::UpdateWorldTransforms();
+		CHECK(middle->GetWorldTransformVersion() == middleVersion);
+		CHECK(sibling->GetWorldTransform().GetTranslation() == (middle->GetWorldTransform() * vec4(sibling->GetPosition(), 1.0f)).ToVec3());
+	}
+
+	SECTION("Hierarchy")
+	{
+		auto root = Entity::MakeNew();
+		auto a = root->CreateChild();
+		auto b = root->CreateChild();
+		auto c = root->CreateChild();
+		auto a1 = a->CreateChild();
+		auto a2 = a->CreateChild();
+
+		std::vector<Entity*> order;
+		for (auto& ent : root->GetSubtree())
+		{
+			order.push_back(&ent);
+		}
+		CHECK(order == std::vector<Entity*>({ root.get(), a.get(), a1.get(), a2.get(), b.get(), c.get() }));
+
+		// Traversal stays within the subtree.
+		order.clear();
+		for (auto& ent : a->GetSubtree())
+		{
+			order.push_back(&ent);
+		}
+		CHECK(order == std::vector<Entity*>({ a.get(), a1.get(), a2.get() }));
+
+		CHECK(a1->GetDepth() == 2);
+		CHECK(a1->GetRoot() == root);
+		CHECK(a1->GetParentNode() == a.get());
+
+		// Removal moves the last child into the vacated position.
+		root->RemoveChild(*a);
+		CHECK(root->GetChildren() == std::vector<Entity::Ptr>({ c, b }));
+		CHECK(a->IsRoot());
+		CHECK(a1->GetDepth() == 1);
+		CHECK(a1->GetRoot() == a);
+
+		// Moving a branch refreshes the cached links of the whole branch.
+		b->AddChild(a);
+		CHECK(a1->GetDepth() == 3);
+		CHECK(a1->GetRoot() == root);
+		c->AddChild(a);
+		CHECK(b->IsLeaf());
+		CHECK(c->GetChildren().front() == a);
+
+		// Changes are signaled to each ancestor once, until the subtree is cleared.
+		root->ClearSubtreeChanged();
+		const u32 rootVersion = root->GetSubtreeVersion();
+		a1->MarkSubtreeChanged();
+		CHECK(root->GetSubtreeVersion() != rootVersion);
+
+		const u32 markedVersion = root->GetSubtreeVersion();
+		a2->MarkSubtreeChanged();
+		CHECK(root->GetSubtreeVersion() == markedVersion);
+
+		a->ClearSubtreeChanged();
+		const u32 branchVersion = a->GetSubtreeVersion();
+		a2->MarkSubtreeChanged();
+		CHECK(a->GetSubtreeVersion() != branchVersion);
+		CHECK(root->GetSubtreeVersion() == markedVersion);
+
+		// Children outliving their parent become roots.
+		root.reset();
+		CHECK(c->IsRoot());
+		CHECK(a1->GetRoot() == c);
+		CHECK(a2->GetDepth() == 2);
+
+		// Deep branches are neither traversed nor destroyed recursively.
+		const u32 numEntities = World::GetDefault().GetNumEntities();
+		auto deepRoot = Entity::MakeNew();
+		Entity::Ptr deepLeaf = deepRoot;
+		for (u32 i = 0; i < 100000; ++i)
+		{
+			deepLeaf = deepLeaf->CreateChild();
+		}
+		deepRoot->SetPosition(vec3(1.0f, 0.0f, 0.0f));
+
+		CHECK(deepLeaf->GetDepth() == 100000);
+		CHECK(deepLeaf->GetRoot() == deepRoot);
+		CHECK(deepLeaf->GetWorldTransform().GetTranslation() == vec3(1.0f, 0.0f, 0.0f));
+		CHECK(std::distance(deepRoot->GetSubtree().begin(), deepRoot->GetSubtree().end()) == 100001);
+
+		deepLeaf.reset();
+		deepRoot.reset();
+		CHECK(World::GetDefault().GetNumEntities() == numEntities);
+	}
+
+	SECTION("Subtree Queries")
+	{
+		auto vehicle = Entity::MakeNew();
+		vehicle->Add<Comp1>();
+		auto wheel = vehicle->CreateChild();
+		wheel->Add<Comp1>();
+		wheel->Add<Comp2>();
+		wheel->Tag<TagA>();
+		auto hubcap = wheel->CreateChild();
+		hubcap->Add<Comp2>();
+		hubcap->Tag<TagA>();
+		auto disabledWheel = vehicle->CreateChild();
+		disabledWheel->Add<Comp1>();
+		disabledWheel->Add<Comp2>();
+		disabledWheel->Disable();
+
+		// Matching Entities outside of the subtree are ignored.
+		auto other = Entity::MakeNew();
+		other->Add<Comp1>();
+		other->Add<Comp2>();
+
+		std::vector<Entity*> found;
+		for (Entity& ent : vehicle->With<Comp1>())
+		{
+			found.push_back(&ent);
+		}
+		CHECK(found == std::vector<Entity*>({ vehicle.get(), wheel.get() }));
+
+		found.clear();
+		for (Entity& ent : vehicle->With<Comp2, TagA>())
+		{
+			found.push_back(&ent);
+		}
+		CHECK(found == std::vector<Entity*>({ wheel.get(), hubcap.get() }));
+
+		CHECK(std::distance(wheel->With<Comp1, Comp2>().begin(), wheel->With<Comp1, Comp2>().end()) == 1);
+		CHECK(hubcap->With<Comp1>().begin() == hubcap->With<Comp1>().end());
+		CHECK(vehicle->With<TagB>().begin() == vehicle->With<TagB>().end());
+
+		// Changed<> filters as usual.
+		const u64 version = GetLatestChangeVersion();
+		CHECK(vehicle->With<Changed<Comp2>>(version).begin() == vehicle->With<Changed<Comp2>>(version).end());
+		hubcap->Get<Comp2>().MarkChanged();
+		CHECK(&*vehicle->With<Changed<Comp2>>(version).begin() == hubcap.get());
+	}
+
+	SECTION("Serialization")
+	{
+		ComponentRegistry.Register<Counter>("Counter")
+			.Field("visits", &Counter::visits);
+		ComponentRegistry.Register<Name>("Name")
+			.Field("name", &Name::GetName, &Name::SetName);
+		ComponentRegistry.Register<TagA>("TagA");
+
+		auto root = Entity::MakeNew();
+		root->Add<Name>("Root");
+		root->Add<Counter>().visits = 3;
+		root->SetPosition(vec3(1.0f, 2.0f, 3.0f));
+		auto child = root->CreateChild();
+		child->Add<Counter>().visits = 7;
+		child->Disable<Counter>();
+		child->Tag<TagA>();
+		auto grandChild = child->CreateChild();
+		grandChild->Add<Name>("GrandChild");
+		grandChild->Add<Comp1>();
+		grandChild->Tag<TagA>();
+		grandChild->SetScale(vec3(2.0f));
+		auto disabledChild = root->CreateChild();
+		disabledChild->Add<Counter>().visits = 11;
+		disabledChild->Disable();
+
+		CHECK(ComponentRegistry.GetTypes().size() == 3);
+		CHECK(ComponentRegistry.Find("Counter")->IsFixedSize());
+		CHECK(ComponentRegistry.Find("Counter")->GetRecordSize() == sizeof(u32));
+		CHECK(!ComponentRegistry.Find("Name")->IsFixedSize());
+		CHECK(ComponentRegistry.FindTag(TagA::GetComponentId()) == ComponentRegistry.Find("TagA"));
+
+		auto data = SaveScene(*root);
+		World world;
+		auto loaded = LoadScene(data.data(), data.size(), world);
+		REQUIRE(loaded);
+		REQUIRE(loaded->GetChildren().size() == 2);
+
+		auto& loadedChild = *loaded->GetChildren()[0];
+		auto& loadedDisabled = *loaded->GetChildren()[1];
+		REQUIRE(loadedChild.GetChildren().size() == 1);
+		auto& loadedGrandChild = *loadedChild.GetChildren()[0];
+
+		CHECK(&loaded->GetWorld() == &world);
+		CHECK(loaded->Get<Name>().GetName() == "Root");
+		CHECK(loaded->Get<Counter>().visits == 3);
+		CHECK(loaded->GetPosition() == vec3(1.0f, 2.0f, 3.0f));
+		CHECK(loadedChild.Get<Counter>().visits == 7);
+		CHECK(!loadedChild.Get<Counter>().IsComponentEnabled());
+		CHECK(loadedChild.HasTag<TagA>());
+		CHECK(loadedGrandChild.Get<Name>().GetName() == "GrandChild");
+		CHECK(loadedGrandChild.GetScale() == vec3(2.0f));
+		CHECK(loadedGrandChild.HasTag<TagA>());
+		// Unregistered types are skipped.
+		CHECK(!loadedGrandChild.Has<Comp1>());
+		CHECK(!loadedDisabled.IsEnabled());
+		CHECK(loadedDisabled.Get<Counter>().visits == 11);
+
+		// The loaded scene is indexed like any other.
+		CHECK(FindEntity("GrandChild", world).get() == &loadedGrandChild);
+		CHECK(std::distance(world.With<Counter>().begin(), world.With<Counter>().end()) == 1);
+		CHECK(std::distance(world.With<TagA>().begin(), world.With<TagA>().end()) == 2);
+		loadedDisabled.Enable();
+		CHECK(std::distance(world.With<Counter>().begin(), world.With<Counter>().end()) == 2);
+
+		// Invalid data is rejected.
+		CHECK(!LoadScene(data.data(), data.size() / 2, world));
+		// Counts which can't fit in the data are rejected before allocating for them.
+		std::vector<u8> forged = data;
+		const u32 hugeCount = 0x7FFFFFFF;
+		std::memcpy(&forged[sizeof(u32) * 2], &hugeCount, sizeof(u32));
+		CHECK(!LoadScene(forged.data(), forged.size(), world));
+		data[0] = 0;
+		CHECK(!LoadScene(data.data(), data.size(), world));
+
+		// Fields which are no longer registered are ignored.
+		ComponentRegistry.Clear();
+		ComponentRegistry.Register<Counter>("Counter");
+		data = SaveScene(*root);
+		ComponentRegistry.Clear();
+		ComponentRegistry.Register<Counter>("Counter")
+			.Field("visits", &Counter::visits);
+		loaded = LoadScene(data.data(), data.size(), world);
+		REQUIRE(loaded);
+		CHECK(loaded->Get<Counter>().visits == 0);
+		CHECK(!loaded->Has<Name>());
+
+		ComponentRegistry.Clear();
+	}
+
+	SECTION("System Scheduler")
+	{
+		CHECK(!SystemAccess().Reads<Comp1>().ConflictsWith(SystemAccess().Reads<Comp1>()));
+		CHECK(SystemAccess().Reads<Comp1>().ConflictsWith(SystemAccess().Writes<Comp1>()));
+		CHECK(SystemAccess().Writes<Comp1>().ConflictsWith(SystemAccess().Writes<Comp1, Comp2>()));
+		CHECK(!SystemAccess().Writes<Comp1>().ConflictsWith(SystemAccess().Writes<Comp2>().ReadsTransforms()));
+		CHECK(SystemAccess().ReadsTransforms().ConflictsWith(SystemAccess().WritesTransforms()));
+		CHECK(SystemAccess().Exclusive().ConflictsWith(SystemAccess()));
+
+		std::atomic<u32> writes1(0);
+		std::atomic<u32> writes2(0);
+		bool readAfterWrite = false;
+		bool exclusiveRanLast = false;
+
+		SystemScheduler.Add("Write1", SystemAccess().Writes<Comp1>(), [&] { writes1++; });
+		SystemScheduler.Add("Write2", SystemAccess().Writes<Comp2>(), [&] { writes2++; });
+		SystemScheduler.Add("Read1", SystemAccess().Reads<Comp1>().OnMainThread(), [&] {
+			readAfterWrite = writes1 == 1;
+		});
+		SystemScheduler.Add("Exclusive", SystemAccess().Exclusive(), [&] {
+			exclusiveRanLast = writes1 == 1 && writes2 == 1 && readAfterWrite;
+		});
+		CHECK(SystemScheduler.Has("Read1"));
+
+		// The writers share a stage. The reader must wait for Write1, and the exclusive system for everyone.
+		CHECK(SystemScheduler.GetNumStages() == 3);
+
+		SystemScheduler.Run();
+		CHECK(writes1 == 1);
+		CHECK(writes2 == 1);
+		CHECK(readAfterWrite);
+		CHECK(exclusiveRanLast);
+
+		SystemScheduler.Remove("Exclusive");
+		CHECK(!SystemScheduler.Has("Exclusive"));
+		CHECK(SystemScheduler.GetNumStages() == 2);
+
+		SystemScheduler.Clear();
+		CHECK(SystemScheduler.GetNumStages() == 0);
+	}
+
 	SECTION("Queries")
 	{
 		auto ent1 = Entity::MakeNew();
@@ -682,6 +1603,218 @@ TEST_CASE("Entity-Component-System")
 				CHECK(count == 0);
 			}
 
+			SECTION("Changed<>")
+			{
+				ent1->AddComponents<Comp1, Comp2>();
+				ent2->AddComponents<Comp1, Comp2>();
+				ent3->Add<DerivedA>();
+
+				// Everything has changed since the beginning, because Components are flagged when they are added.
+				auto count = 0;
+				for (Entity& e : With<Changed<Comp1>, Comp2>())
+				{
+					count++;
+				}
+				CHECK(count == 2);
+
+				const u64 since = GetLatestChangeVersion();
+				for (Entity& e : With<Changed<Comp1>, Comp2>(since))
+				{
+					FAIL("Nothing has changed yet.");
+				}
+
+				ent2->Get<Comp1>().MarkChanged();
+				ent3->Get<Base>().MarkChanged();
+				ent4->Add<Comp1>();
+				ent4->Add<Comp2>();
+				CHECK(ent2->Get<Comp1>().HasChangedSince(since));
+				CHECK(!ent1->Get<Comp1>().HasChangedSince(since));
+
+				count = 0;
+				for (Entity& e : With<Comp2, Changed<Comp1>>(since))
+				{
+					count++;
+					CHECK((&e == ent2.get() || &e == ent4.get()));
+				}
+				CHECK(count == 2);
+
+				// All wrapped Components must have changed.
+				count = 0;
+				for (Entity& e : With<Changed<Comp1>, Changed<Comp2>>(since))
+				{
+					count++;
+					CHECK(&e == ent4.get());
+				}
+				CHECK(count == 1);
+
+				// Derived Components are matched through their base.
+				count = 0;
+				for (Entity& e : With<Changed<Base>>(since))
+				{
+					count++;
+					CHECK(&e == ent3.get());
+				}
+				CHECK(count == 1);
+			}
+
+			SECTION("Skewed Tables")
+			{
+				// Many Entities share a common Tag, but only a few of them have the rare Component.
+				std::vector<Entity::Ptr> crowd;
+				for (u32 i = 0; i < 256; ++i)
+				{
+					crowd.push_back(Entity::MakeNew());
+					crowd.back()->Tag<TagA>();
+
+					if (i % 64 == 0)
+					{
+						crowd.back()->Add<Comp1>();
+					}
+				}
+
+				// The result is the same regardless of argument order, since the rarest table always drives the iteration.
+				std::vector<Entity*> order1;
+				for (Entity& e : With<TagA, Comp1>())
+				{
+					order1.push_back(&e);
+				}
+
+				std::vector<Entity*> order2;
+				for (Entity& e : With<Comp1, TagA>())
+				{
+					order2.push_back(&e);
+				}
+
+				CHECK(order1.size() == 4);
+				CHECK(order1 == order2);
+
+				// An empty table ends the query immediately.
+				auto count = 0;
+				for (Entity& e : With<TagA, Comp1, Comp2>())
+				{
+					count++;
+				}
+				CHECK(count == 0);
+			}
+
+			SECTION("Query<>")
+			{
+				// Entities matching before the Query exists are picked up on construction.
+				ent1->AddComponents<Comp1, Comp2>();
+				ent1->Tag<TagA>();
+				ent2->Add<Comp1>();
+				ent2->Tag<TagA>();
+
+				Query<Comp1, Comp2, TagA> query;
+				CHECK(query.Size() == 1);
+				CHECK(query.Contains(*ent1));
+
+				// Entities start matching as soon as their last missing piece is added.
+				ent2->Add<Comp2>();
+				ent3->Tag<TagA>();
+				ent3->Add<Comp2>();
+				ent3->Add<Comp1>();
+				CHECK(query.Size() == 3);
+				CHECK(query.Contains(*ent2));
+				CHECK(query.Contains(*ent3));
+
+				// Disabling, removing, and destroying all stop an Entity from matching.
+				ent1->Disable();
+				ent2->Disable<Comp1>();
+				ent3->RemoveTag<TagA>();
+				ent4->AddComponents<Comp1, Comp2>();
+				ent4->Tag<TagA>();
+				ent4.reset();
+				CHECK(query.IsEmpty());
+
+				ent1->Enable();
+				ent2->Enable<Comp1>();
+
+				auto count = 0;
+				for (Entity& e : query)
+				{
+					count++;
+					CHECK((&e == ent1.get() || &e == ent2.get()));
+					CHECK(e.Get<Comp1>().IsEnabled());
+					CHECK(e.Get<Comp2>().IsEnabled());
+					CHECK(e.HasTag<TagA>());
+				}
+				CHECK(count == 2);
+
+				// The result matches an equivalent With<>().
+				count = 0;
+				for (Entity& e : With<TagA, Comp2, Comp1>())
+				{
+					count++;
+					CHECK(query.Contains(e));
+				}
+				CHECK(count == 2);
+			}
+
+			SECTION("Parallel")
+			{
+				// Enough instances to span several chunks and batches.
+				const u32 numEntities = World::GetDefault().GetStorage<Counter>().GetChunkCapacity() * 4 + 1;
+
+				std::vector<Entity::Ptr> entities;
+				for (u32 i = 0; i < numEntities; i++)
+				{
+					entities.push_back(Entity::MakeNew());
+					entities.back()->Add<Counter>();
+
+					if (i % 3 == 0)
+					{
+						entities.back()->Tag<TagA>();
+					}
+				}
+				entities[1]->Disable<Counter>();
+
+				// Every enabled Component is visited exactly once.
+				ParallelForEach<Counter>([](Counter& counter) {
+					counter.visits++;
+				});
+
+				for (u32 i = 0; i < numEntities; i++)
+				{
+					CHECK(entities[i]->Get<Counter>().visits == (i == 1 ? 0u : 1u));
+				}
+
+				// Only matching Entities are visited.
+				ParallelWith<TagA, Counter>([](Entity& e) {
+					e.Get<Counter>().visits++;
+				});
+
+				Query<Counter, TagA> query;
+				query.ParallelForEach([](Entity& e) {
+					e.Get<Counter>().visits++;
+				});
+
+				for (u32 i = 0; i < numEntities; i++)
+				{
+					CHECK(entities[i]->Get<Counter>().visits == (i == 1 ? 0u : (i % 3 == 0 ? 3u : 1u)));
+				}
+
+				// Separate branches can be moved in parallel.
+				ParallelWith<TagA, Counter>([](Entity& e) {
+					e.SetPosition(vec3(1.0f, 2.0f, 3.0f));
+				});
+				Entity::UpdateWorldTransforms();
+
+				for (u32 i = 0; i < numEntities; i += 3)
+				{
+					CHECK(entities[i]->GetWorldTransform().GetTranslation() == vec3(1.0f, 2.0f, 3.0f));
+				}
+
+				// Loops started from inside of a task are run on the calling thread.
+				std::atomic<u32> total(0);
+				WorkerPool.ParallelFor(8, [&](u32) {
+					WorkerPool.ParallelFor(8, [&](u32) {
+						total++;
+					});
+				});
+				CHECK(total == 64);
+			}
+
 			SECTION("CaptureWith<>()")
 			{
 				// Target #1 with Comp1/Comp2
@@ -721,6 +1854,136 @@ TEST_CASE("Entity-Component-System")
 				CHECK(foundEnt2);
 				CHECK(count == 2);
 			}
+
+			SECTION("EntityCommandBuffer")
+			{
+				ent1->Add<Comp1>();
+				ent2->Add<Comp1>();
+				ent3->Add<Comp1>();
+				ent3->Add<Comp2>();
+
+				// Structural changes to the queried types are safe to record during iteration.
+				EntityCommandBuffer commands;
+				for (Entity& e : With<Comp1>())
+				{
+					commands.Remove<Comp1>(e);
+					commands.Add<Comp2>(e);
+					commands.Tag<TagA>(e);
+				}
+				CHECK(commands.GetNumCommands() == 9);
+
+				// Nothing changes until playback.
+				CHECK(ent1->Has<Comp1>());
+				CHECK(!ent1->HasTag<TagA>());
+
+				commands.Playback();
+				CHECK(commands.IsEmpty());
+
+				auto count = 0;
+				for (Entity& e : With<Comp2, TagA>())
+				{
+					count++;
+					CHECK(!e.Has<Comp1>());
+				}
+				CHECK(count == 3);
+
+				// Commands on the same Entity and type are applied in order.
+				commands.Add<Comp1>(*ent4);
+				commands.Disable(*ent4);
+				commands.Disable<Comp1>(*ent4);
+				commands.Enable<Comp1>(*ent4);
+				commands.RemoveTag<TagA>(*ent1);
+				commands.Tag<TagA>(*ent1);
+				commands.Remove<Comp2>(*ent2);
+				commands.Playback();
+
+				CHECK(ent4->Has<Comp1>());
+				CHECK(ent4->Get<Comp1>().IsComponentEnabled());
+				CHECK(!ent4->IsEnabled());
+				CHECK(ent1->HasTag<TagA>());
+				CHECK(!ent2->Has<Comp2>());
+
+				// Destroyed Entities are detached and emptied.
+				auto child = ent1->CreateChild();
+				child->Add<Comp1>();
+				child->Tag<TagB>();
+				commands.Destroy(*child);
+				commands.Playback();
+
+				CHECK(ent1->IsLeaf());
+				CHECK(!child->Has<Comp1>());
+				CHECK(!child->HasTag<TagB>());
+
+				// Recording from a parallel query.
+				std::vector<Entity::Ptr> entities;
+				for (u32 i = 0; i < 1000; i++)
+				{
+					entities.push_back(Entity::MakeNew());
+					entities.back()->Add<Counter>();
+				}
+
+				ParallelForEach<Counter>([&](Counter& counter) {
+					commands.Tag<TagC>(counter.owner);
+				});
+				CHECK(commands.GetNumCommands() == 1000);
+				commands.Playback();
+
+				count = 0;
+				for (Entity& e : With<Counter, TagC>())
+				{
+					count++;
+				}
+				CHECK(count == 1000);
+			}
 		}
 	}
 }
+
+//- Compares per-entity lookups by Component ID, with 1 to 32 Components on each Entity.
+//- Every Entity is probed for all 32 types, so the results include both hits and misses.
+//- Hidden by default. Run with the [benchmark] tag.
+TEST_CASE("Component Lookup Benchmark", "[.][benchmark]")
+{
+	const u32 numEntities = 4096;
+	const u32 numRepeats = 8;
+
+	Log("Components | Linear Scan (ms) | ComponentMap (ms)");
+
+	for (u32 count = 1; count <= 32; count *= 2)
+	{
+		std::vector<Entity::Ptr> entities;
+		std::vector<std::vector<ComponentBase*>> componentLists(numEntities);
+		for (u32 i = 0; i < numEntities; i++)
+		{
+			entities.push_back(Entity::MakeNew());
+			AddNumbered(*entities.back(), count, componentLists[i], NumberedSequence());
+		}
+
+		u32 linearFound = 0;
+		Timer timer;
+		for (u32 repeat = 0; repeat < numRepeats; repeat++)
+		{
+			for (u32 i = 0; i < numEntities; i++)
+			{
+				linearFound += LookupLinear(componentLists[i], NumberedSequence());
+			}
+		}
+		const f64 linearTime = timer.GetElapsedMS();
+
+		u32 mappedFound = 0;
+		timer.Reset();
+		for (u32 repeat = 0; repeat < numRepeats; repeat++)
+		{
+			for (auto& ent : entities)
+			{
+				mappedFound += LookupMapped(*ent, NumberedSequence());
+			}
+		}
+		const f64 mappedTime = timer.GetElapsedMS();
+
+		CHECK(linearFound == numEntities * numRepeats * count);
+		CHECK(mappedFound == linearFound);
+
+		Log("%10u | %16.3f | %17.3f", count, linearTime, mappedTime);
+	}
+}
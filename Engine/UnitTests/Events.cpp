@@ -0,0 +1,396 @@
+#include <catch.hpp>
+#include <Jewel3D/Application/Event.h>
+#include <Jewel3D/Application/HierarchicalEvent.h>
+#include <Jewel3D/Application/TimerWheel.h>
+#include <Jewel3D/Utilities/InlineFunction.h>
+#include <Jewel3D/Utilities/RingBuffer.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace Jwl;
+
+class Damage : public Event<Damage>
+{
+public:
+	Damage(u32 _amount) : amount(_amount) {}
+
+	u32 amount;
+};
+
+class Sound : public Event<Sound>
+{
+public:
+	Sound(const std::string& _name) : name(_name) {}
+
+	std::string name;
+};
+
+TEST_CASE("Events")
+{
+	SECTION("Ring Buffer")
+	{
+		RingBuffer<std::string> buffer;
+		CHECK(buffer.IsEmpty());
+
+		// Wrap around the end of the buffer before growing it.
+		for (u32 i = 0; i < 12; ++i)
+		{
+			buffer.Emplace(std::to_string(i));
+		}
+		for (u32 i = 0; i < 10; ++i)
+		{
+			buffer.PopFront();
+		}
+		for (u32 i = 12; i < 40; ++i)
+		{
+			buffer.Emplace(std::to_string(i));
+		}
+
+		REQUIRE(buffer.Size() == 30);
+		for (u32 i = 0; i < buffer.Size(); ++i)
+		{
+			CHECK(buffer[i] == std::to_string(i + 10));
+		}
+
+		const u32 capacity = buffer.GetCapacity();
+		buffer.Clear();
+		CHECK(buffer.IsEmpty());
+		CHECK(buffer.GetCapacity() == capacity);
+	}
+
+	SECTION("Inline Function")
+	{
+		auto counter = std::make_shared<u32>(0);
+		InlineFunction<u32(u32)> small = [counter](u32 x) { return ++(*counter) + x; };
+		CHECK(decltype(small)::IsStoredInline<std::shared_ptr<u32>>());
+
+		struct Large { u8 data[128]; };
+		Large large = {};
+		large.data[127] = 5;
+		InlineFunction<u32(u32)> big = [large](u32 x) { return large.data[127] + x; };
+		CHECK(!decltype(big)::IsStoredInline<Large>());
+
+		CHECK(small(10) == 11);
+		CHECK(big(10) == 15);
+
+		// Copies share nothing but the captured values.
+		auto smallCopy = small;
+		auto bigCopy = big;
+		CHECK(smallCopy(0) == 2);
+		CHECK(bigCopy(1) == 6);
+		CHECK(counter.use_count() == 3);
+
+		// Moving never copies the callable, so containers of them can grow without allocating.
+		CHECK(std::is_nothrow_move_constructible<InlineFunction<u32(u32)>>::value);
+		auto moved = std::move(smallCopy);
+		CHECK(!smallCopy);
+		CHECK(moved(0) == 3);
+
+		small = nullptr;
+		moved.Reset();
+		CHECK(!small);
+		CHECK(counter.use_count() == 1);
+
+		big = std::move(bigCopy);
+		CHECK(big(0) == 5);
+	}
+
+	SECTION("Listeners")
+	{
+		u32 count = 0;
+		std::vector<std::unique_ptr<Listener<Damage>>> listeners;
+		for (u32 i = 0; i < 1000; ++i)
+		{
+			listeners.push_back(std::make_unique<Listener<Damage>>([&](const Damage&) { count++; }));
+		}
+
+		// Remove every other listener, out of order.
+		for (u32 i = 0; i < listeners.size(); i += 2)
+		{
+			listeners[i].reset();
+		}
+
+		EventQueue.Dispatch(Damage(1));
+		CHECK(count == 500);
+		CHECK(Damage::GetListenersStatic().size() == 500);
+
+		listeners.clear();
+		CHECK(!Damage::HasListenersStatic());
+
+		// Listeners can unsubscribe themselves, and subscribe new ones, while the event is being raised.
+		count = 0;
+		std::unique_ptr<Listener<Damage>> added;
+		std::unique_ptr<Listener<Damage>> removed;
+		Listener<Damage> onDamage([&](const Damage&) {
+			count++;
+			removed.reset();
+			if (!added)
+			{
+				added = std::make_unique<Listener<Damage>>([&](const Damage&) { count += 10; });
+			}
+		});
+		removed = std::make_unique<Listener<Damage>>([&](const Damage&) { count += 100; });
+
+		// The new listener does not receive the event in flight.
+		EventQueue.Dispatch(Damage(1));
+		CHECK(count == 1);
+		CHECK(Damage::GetListenersStatic().size() == 2);
+
+		EventQueue.Dispatch(Damage(1));
+		CHECK(count == 12);
+
+		// Copies are subscribed separately.
+		Listener<Damage> copy = onDamage;
+		EventQueue.Dispatch(Damage(1));
+		CHECK(count == 24);
+	}
+
+	SECTION("Queued Events")
+	{
+		std::vector<std::string> received;
+		Listener<Damage> onDamage([&](const Damage& e) { received.push_back(std::to_string(e.amount)); });
+		Listener<Sound> onSound([&](const Sound& e) { received.push_back(e.name); });
+
+		EventQueue.Push<Damage>(1u);
+		EventQueue.Push<Sound>("Hit");
+		EventQueue.Push<Damage>(2u);
+		CHECK(received.empty());
+
+		// Events of different types are delivered in the order that they were pushed.
+		EventQueue.Dispatch();
+		CHECK(received == std::vector<std::string>({ "1", "Hit", "2" }));
+
+		received.clear();
+		EventQueue.Dispatch();
+		CHECK(received.empty());
+
+		// Consecutive events of a type are delivered together.
+		EventQueue.Push<Sound>("Press");
+		EventQueue.Push<Damage>(4u);
+		EventQueue.Push<Damage>(5u);
+		EventQueue.Push<Sound>("Release");
+		EventQueue.Push<Sound>("Press");
+		EventQueue.Dispatch();
+		CHECK(received == std::vector<std::string>({ "Press", "4", "5", "Release", "Press" }));
+
+		received.clear();
+
+		// Immediate dispatch bypasses the queue.
+		EventQueue.Dispatch(Damage(3));
+		CHECK(received == std::vector<std::string>({ "3" }));
+	}
+
+	SECTION("No Listeners")
+	{
+		u32 count = 0;
+		{
+			Listener<Damage> onDamage([&](const Damage&) { count++; });
+		}
+
+		// Events without listeners are not queued at all.
+		EventQueue.Push<Damage>(1u);
+		Listener<Damage> onDamage([&](const Damage&) { count++; });
+		EventQueue.Dispatch();
+		CHECK(count == 0);
+	}
+
+	SECTION("Pushing During Dispatch")
+	{
+		std::vector<u32> received;
+		Listener<Damage> onDamage([&](const Damage& e) {
+			received.push_back(e.amount);
+			if (e.amount < 3)
+			{
+				EventQueue.Push<Damage>(e.amount + 1);
+			}
+		});
+
+		// Each follow-up event is delivered by the next Dispatch().
+		EventQueue.Push<Damage>(1u);
+		EventQueue.Dispatch();
+		CHECK(received == std::vector<u32>({ 1 }));
+		EventQueue.Dispatch();
+		CHECK(received == std::vector<u32>({ 1, 2 }));
+		EventQueue.Dispatch();
+		EventQueue.Dispatch();
+		CHECK(received == std::vector<u32>({ 1, 2, 3 }));
+	}
+
+	SECTION("Posting From Threads")
+	{
+		const u32 numThreads = 4;
+		const u32 numEvents = 10000;
+
+		std::vector<std::vector<u32>> received(numThreads);
+		Listener<Damage> onDamage([&](const Damage& e) { received[e.amount / numEvents].push_back(e.amount % numEvents); });
+
+		std::vector<std::thread> threads;
+		for (u32 t = 0; t < numThreads; ++t)
+		{
+			threads.emplace_back([t, numEvents]() {
+				for (u32 i = 0; i < numEvents; ++i)
+				{
+					EventQueue.Post<Damage>(t * numEvents + i);
+				}
+			});
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		EventQueue.Dispatch();
+
+		// The events from each thread arrive in the order that they were posted.
+		for (auto& events : received)
+		{
+			REQUIRE(events.size() == numEvents);
+			for (u32 i = 0; i < numEvents; ++i)
+			{
+				CHECK(events[i] == i);
+			}
+		}
+	}
+
+	SECTION("Hierarchical Events")
+	{
+		std::vector<std::string> received;
+		auto makeWidget = [&](Entity& parent, const std::string& name, bool handles) {
+			auto widget = parent.CreateChild();
+			widget->Add<ProxyListener<Damage>>().callback = [&received, name, handles](const Damage&) {
+				received.push_back(name);
+				return handles;
+			};
+			return widget;
+		};
+
+		auto ui = Entity::MakeNew();
+		ui->Add<EventDispatcher<Damage>>();
+		auto panel = makeWidget(*ui, "Panel", false);
+		auto button = makeWidget(*panel, "Button", false);
+		auto label = makeWidget(*ui, "Label", false);
+		auto icon = makeWidget(*label, "Icon", false);
+
+		// Siblings are notified before their descendants.
+		EventQueue.Dispatch(Damage(1));
+		CHECK(received == std::vector<std::string>({ "Panel", "Label", "Button", "Icon" }));
+
+		// Changes to the hierarchy and to the listeners are picked up.
+		received.clear();
+		label->Disable<ProxyListener<Damage>>();
+		button->RemoveComponent<ProxyListener<Damage>>();
+		auto popup = makeWidget(*icon, "Popup", false);
+		EventQueue.Dispatch(Damage(1));
+		CHECK(received == std::vector<std::string>({ "Panel", "Icon", "Popup" }));
+
+		received.clear();
+		ui->RemoveChild(*label);
+		EventQueue.Dispatch(Damage(1));
+		CHECK(received == std::vector<std::string>({ "Panel" }));
+
+		// Handling the event stops propagation.
+		received.clear();
+		ui->AddChild(label);
+		label->Enable<ProxyListener<Damage>>();
+		panel->Get<ProxyListener<Damage>>().callback = [&](const Damage&) {
+			received.push_back("Panel");
+			return true;
+		};
+		EventQueue.Dispatch(Damage(1));
+		CHECK(received == std::vector<std::string>({ "Panel" }));
+
+		// Listeners can be removed during propagation, without notifying the others twice.
+		received.clear();
+		panel->Get<ProxyListener<Damage>>().callback = [&](const Damage&) {
+			received.push_back("Panel");
+			popup.reset();
+			icon->ClearChildren();
+			return false;
+		};
+		EventQueue.Dispatch(Damage(1));
+		CHECK(received == std::vector<std::string>({ "Panel", "Label", "Icon" }));
+
+		ui->Disable<EventDispatcher<Damage>>();
+		received.clear();
+		EventQueue.Dispatch(Damage(1));
+		CHECK(received.empty());
+	}
+
+	SECTION("Timers")
+	{
+		TimerWheel timers;
+		std::vector<u64> fired;
+		auto record = [&]() { fired.push_back(timers.GetCurrentTick()); };
+
+		// Delays spanning every level of the wheel fire exactly on time.
+		const std::vector<u32> delays = { 1, 255, 256, 257, 1000, 65535, 65536, 70000, 1u << 24 };
+		for (u32 delay : delays)
+		{
+			timers.Schedule(delay, record);
+		}
+		CHECK(timers.GetNumTimers() == delays.size());
+
+		timers.Advance(1u << 24);
+		CHECK(fired == std::vector<u64>(delays.begin(), delays.end()));
+		CHECK(timers.GetNumTimers() == 0);
+
+		// Repeating timers fire until cancelled, and handles expire with their timers.
+		fired.clear();
+		const u64 start = timers.GetCurrentTick();
+		auto repeating = timers.ScheduleRepeating(300, record);
+		auto once = timers.Schedule(10, record);
+		auto cancelled = timers.Schedule(20, record);
+		CHECK(timers.GetRemainingTicks(cancelled) == 20);
+		CHECK(timers.Cancel(cancelled));
+		CHECK(!timers.Cancel(cancelled));
+
+		timers.Advance(1000);
+		CHECK(fired == std::vector<u64>({ start + 10, start + 300, start + 600, start + 900 }));
+		CHECK(!timers.IsScheduled(once));
+		CHECK(timers.IsScheduled(repeating));
+		CHECK(timers.GetRemainingTicks(repeating) == 200);
+
+		// The handle of a released timer does not affect the timer that reuses its memory.
+		auto reused = timers.Schedule(5, record);
+		CHECK(!timers.Cancel(once));
+		CHECK(timers.IsScheduled(reused));
+
+		// Timers can cancel themselves and schedule others from their callbacks.
+		fired.clear();
+		TimerHandle self;
+		self = timers.ScheduleRepeating(1, [&]() {
+			record();
+			timers.Cancel(self);
+			timers.Schedule(2, record);
+		});
+		timers.Cancel(repeating);
+		timers.Advance(10);
+		CHECK(fired.size() == 3);
+		CHECK(timers.GetNumTimers() == 0);
+	}
+
+	SECTION("Timed Events")
+	{
+		std::vector<u32> received;
+		Listener<Damage> onDamage([&](const Damage& e) { received.push_back(e.amount); });
+
+		TimerWheel timers;
+		timers.ScheduleEvent<Damage>(2, 5u);
+		auto poison = timers.ScheduleRepeatingEvent<Damage>(3, 1u);
+
+		for (u32 i = 0; i < 9; ++i)
+		{
+			timers.Advance();
+			EventQueue.Dispatch();
+		}
+		CHECK(received == std::vector<u32>({ 5, 1, 1, 1 }));
+
+		timers.Clear();
+		CHECK(!timers.IsScheduled(poison));
+	}
+}